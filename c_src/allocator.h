@@ -1,26 +1,85 @@
 #pragma once
 #include <erl_nif.h>
 #include "duckdb.hpp"
+#include <atomic>
 
 namespace nif {
+  /*
+   * The counters of the database allocator, DuckDB passes them to the allocate functions
+   * as the private data. The functions below are the backend of the counting allocator,
+   * a size-class pool or arena can take their place keeping the accounting.
+   */
+  struct AllocatorStats : public duckdb::PrivateAllocatorData {
+    std::atomic<uint64_t> live_bytes;
+    std::atomic<uint64_t> peak_bytes;
+    std::atomic<uint64_t> allocations;
+
+    AllocatorStats() : live_bytes(0), peak_bytes(0), allocations(0) {}
+
+    void allocated(duckdb::idx_t n) {
+      allocations.fetch_add(1, std::memory_order_relaxed);
+      grow(n);
+    }
+
+    void grow(duckdb::idx_t n) {
+      uint64_t live = live_bytes.fetch_add(n, std::memory_order_relaxed) + n;
+      uint64_t peak = peak_bytes.load(std::memory_order_relaxed);
+      while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+
+    void shrink(duckdb::idx_t n) {
+      live_bytes.fetch_sub(n, std::memory_order_relaxed);
+    }
+  };
+
   inline duckdb::data_ptr_t eddb_allocate(duckdb::PrivateAllocatorData *private_data, duckdb::idx_t n) {
     if(n > std::size_t(-1) / sizeof(duckdb::data_t))
       throw std::bad_alloc();
 
-    if(auto p = static_cast<duckdb::data_ptr_t>(enif_alloc(n * sizeof(duckdb::data_t))))
+    if(auto p = static_cast<duckdb::data_ptr_t>(enif_alloc(n * sizeof(duckdb::data_t)))) {
+      if (private_data)
+        static_cast<AllocatorStats*>(private_data)->allocated(n);
       return p;
+    }
 
     throw std::bad_alloc();
   }
 
   inline void eddb_free(duckdb::PrivateAllocatorData *private_data, duckdb::data_ptr_t p, duckdb::idx_t n) {
     enif_free(p);
+
+    if (private_data)
+      static_cast<AllocatorStats*>(private_data)->shrink(n);
   }
 
   inline duckdb::data_ptr_t eddb_reallocate(duckdb::PrivateAllocatorData *private_data, duckdb::data_ptr_t p, duckdb::idx_t old_size, duckdb::idx_t n) {
-    if(auto rp = static_cast<duckdb::data_ptr_t>(enif_realloc(p, n * sizeof(duckdb::data_t))))
+    if(n > std::size_t(-1) / sizeof(duckdb::data_t))
+      throw std::bad_alloc();
+
+    if(auto rp = static_cast<duckdb::data_ptr_t>(enif_realloc(p, n * sizeof(duckdb::data_t)))) {
+      if (private_data) {
+        auto stats = static_cast<AllocatorStats*>(private_data);
+        if (n > old_size)
+          stats->grow(n - old_size);
+        else
+          stats->shrink(old_size - n);
+      }
       return rp;
+    }
 
     throw std::bad_alloc();
   }
+
+  /*
+   * The allocator of enif_alloc memory (seen by :erlang.memory/0) counting the live and
+   * peak bytes and the allocations of the database, DuckDB takes it from DBConfig on open
+   */
+  inline duckdb::unique_ptr<duckdb::Allocator> make_erlang_allocator() {
+    return duckdb::make_uniq<duckdb::Allocator>(eddb_allocate, eddb_free, eddb_reallocate, duckdb::make_uniq<AllocatorStats>());
+  }
+
+  // nullptr if the database does not use the erlang allocator
+  inline AllocatorStats* get_allocator_stats(duckdb::Allocator& allocator) {
+    return dynamic_cast<AllocatorStats*>(allocator.GetPrivateData());
+  }
 }
@@ -0,0 +1,244 @@
+#include "async_appender.h"
+
+nif::AsyncAppender::AsyncAppender(duckdb::unique_ptr<duckdb::Appender> appender, const AsyncAppenderOptions& options)
+  : appender(std::move(appender)), options(options), writer(this->appender->GetActiveTypes()),
+    pending_rows(0), unflushed_rows(0), unflushed_bytes(0),
+    last_flush(std::chrono::steady_clock::now()), flush_requests(0), flushes_done(0),
+    stopping(false), detached(false), closed(false), failed(false) {}
+
+nif::AsyncAppender::~AsyncAppender() {
+  if (thread.joinable()) {
+    // the thread has released the last reference to the resource
+    if (thread.get_id() == std::this_thread::get_id()) {
+      thread.detach();
+    } else {
+      detach();
+      thread.join();
+    }
+  }
+
+  for (auto& batch : queue)
+    enif_free_env(batch.env);
+}
+
+void nif::AsyncAppender::start(ErrorHandler on_error, ExitHandler on_exit) {
+  this->on_error = std::move(on_error);
+  this->on_exit = std::move(on_exit);
+  thread = std::thread(&AsyncAppender::run, this);
+}
+
+nif::AsyncAppender::Status nif::AsyncAppender::add(ErlNifEnv* rows_env, ERL_NIF_TERM rows, size_t rows_count, std::string& error) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failed) {
+      error = this->error;
+      return FAILED;
+    }
+
+    if (stopping || closed)
+      return CLOSED;
+
+    // the batch larger than the queue is taken when the queue is empty
+    if (pending_rows && pending_rows + rows_count > options.max_pending_rows)
+      return BUSY;
+
+    Batch batch = {rows_env, rows, rows_count};
+    queue.push_back(batch);
+    pending_rows += rows_count;
+  }
+
+  condition.notify_all();
+  return ADDED;
+}
+
+bool nif::AsyncAppender::flush(std::string& error) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (stopping || closed) {
+    error = "appender is closed";
+    return false;
+  }
+
+  uint64_t request = ++flush_requests;
+  condition.notify_all();
+  condition.wait(lock, [this, request] { return failed || flushes_done >= request; });
+
+  if (failed) {
+    error = this->error;
+    return false;
+  }
+
+  return true;
+}
+
+bool nif::AsyncAppender::close(std::string& error) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping || closed) {
+      error = "appender is closed";
+      return false;
+    }
+
+    stopping = true;
+  }
+
+  condition.notify_all();
+  if (thread.joinable())
+    thread.join();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  closed = true;
+
+  if (failed) {
+    error = this->error;
+    return false;
+  }
+
+  try {
+    appender->Close();
+  } catch (std::exception& ex) {
+    error = ex.what();
+    return false;
+  }
+
+  return true;
+}
+
+void nif::AsyncAppender::detach() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping || closed)
+      return;
+
+    stopping = true;
+    detached = true;
+  }
+
+  condition.notify_all();
+}
+
+void nif::AsyncAppender::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!failed) {
+    if (!queue.empty()) {
+      Batch batch = queue.front();
+      queue.pop_front();
+
+      lock.unlock();
+      std::string append_error;
+      size_t bytes = 0;
+      bool appended = append(batch, bytes, append_error);
+      enif_free_env(batch.env);
+      lock.lock();
+
+      pending_rows -= batch.rows_count;
+      if (!appended) {
+        // the failed row is dropped, the rows appended before it are not lost
+        flush_locked(lock);
+        if (!failed)
+          fail(append_error);
+        break;
+      }
+
+      unflushed_rows += batch.rows_count;
+      unflushed_bytes += bytes;
+
+      if ((options.flush_rows && unflushed_rows >= options.flush_rows) ||
+          (options.flush_bytes && unflushed_bytes >= options.flush_bytes))
+        flush_locked(lock);
+
+      continue;
+    }
+
+    if (flushes_done < flush_requests) {
+      uint64_t request = flush_requests;
+      flush_locked(lock);
+      flushes_done = request;
+      condition.notify_all();
+      continue;
+    }
+
+    if (stopping)
+      break;
+
+    if (unflushed_rows && options.flush_interval) {
+      auto at = last_flush + std::chrono::milliseconds(options.flush_interval);
+      if (std::chrono::steady_clock::now() >= at)
+        flush_locked(lock);
+      else
+        condition.wait_until(lock, at);
+    } else {
+      condition.wait(lock);
+    }
+  }
+
+  if (failed) {
+    for (auto& batch : queue)
+      enif_free_env(batch.env);
+    queue.clear();
+    pending_rows = 0;
+  } else if (detached) {
+    lock.unlock();
+    try {
+      appender->Close();
+    } catch (std::exception&) {
+    }
+    lock.lock();
+    closed = true;
+  }
+
+  // the handler may release the last reference to the resource, nothing is touched after it
+  ExitHandler exit_handler = std::move(on_exit);
+  lock.unlock();
+
+  if (exit_handler)
+    exit_handler();
+}
+
+// The rows have been validated by the caller, all of them are the lists of the columns count
+bool nif::AsyncAppender::append(const Batch& batch, size_t& bytes, std::string& error) {
+  try {
+    ERL_NIF_TERM item, row, rows = batch.rows;
+    while (enif_get_list_cell(batch.env, rows, &row, &rows)) {
+      if (!writer.append_row(batch.env, *appender, row, error))
+        return false;
+
+      ErlNifBinary bin;
+      for (ERL_NIF_TERM items = row; enif_get_list_cell(batch.env, items, &item, &items);)
+        bytes += enif_inspect_binary(batch.env, item, &bin) ? bin.size : sizeof(int64_t);
+    }
+  } catch (std::exception& ex) {
+    error = ex.what();
+    return false;
+  }
+
+  return true;
+}
+
+void nif::AsyncAppender::flush_locked(std::unique_lock<std::mutex>& lock) {
+  lock.unlock();
+  std::string flush_error;
+  try {
+    appender->Flush();
+  } catch (std::exception& ex) {
+    flush_error = ex.what();
+  }
+  lock.lock();
+
+  unflushed_rows = 0;
+  unflushed_bytes = 0;
+  last_flush = std::chrono::steady_clock::now();
+
+  if (!flush_error.empty())
+    fail(flush_error);
+}
+
+void nif::AsyncAppender::fail(const std::string& error) {
+  failed = true;
+  this->error = error;
+
+  // nobody is there to report to when the owner has gone
+  if (on_error && !detached)
+    on_error(error);
+
+  condition.notify_all();
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "duckdb.hpp"
+#include "query_options.h"
+#include "row_writer.h"
+#include <erl_nif.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace nif {
+  /*
+   * The appender fed from its own thread. The rows are copied into the bounded queue
+   * and the thread appends them and flushes the appender by the rows count, the bytes
+   * or the time elapsed since the last flush. Once the append or flush fails the
+   * appender is failed for good: the rows appended before the failed row are flushed,
+   * the failed row, the rest of its batch and the queued batches are dropped and
+   * the error is reported.
+   */
+  class AsyncAppender {
+    public:
+      typedef std::function<void(const std::string& error)> ErrorHandler;
+      typedef std::function<void()> ExitHandler;
+
+      enum Status { ADDED, BUSY, FAILED, CLOSED };
+
+      AsyncAppender(duckdb::unique_ptr<duckdb::Appender> appender, const AsyncAppenderOptions& options);
+      ~AsyncAppender();
+
+      AsyncAppender(const AsyncAppender&) = delete;
+      AsyncAppender& operator=(const AsyncAppender&) = delete;
+
+      // on_error is called by the thread with the failure, on_exit is the last thing the thread does
+      void start(ErrorHandler on_error, ExitHandler on_exit);
+
+      size_t columns_count() const { return writer.size(); }
+
+      // Takes the ownership of the env on ADDED only, the error is set on FAILED
+      Status add(ErlNifEnv* rows_env, ERL_NIF_TERM rows, size_t rows_count, std::string& error);
+
+      // Waits until the rows added before are appended and flushed
+      bool flush(std::string& error);
+
+      // Appends the queued rows, joins the thread and closes the appender
+      bool close(std::string& error);
+
+      // Lets the thread append the queued rows and close the appender on its own
+      void detach();
+
+    private:
+      struct Batch {
+        ErlNifEnv* env;
+        ERL_NIF_TERM rows;
+        size_t rows_count;
+      };
+
+      void run();
+      bool append(const Batch& batch, size_t& bytes, std::string& error);
+      void flush_locked(std::unique_lock<std::mutex>& lock);
+      void fail(const std::string& error);
+
+      duckdb::unique_ptr<duckdb::Appender> appender;
+      AsyncAppenderOptions options;
+      RowWriter writer;
+
+      ErrorHandler on_error;
+      ExitHandler on_exit;
+
+      std::mutex mutex;
+      std::condition_variable condition;
+      std::deque<Batch> queue;
+      std::thread thread;
+
+      size_t pending_rows;
+      size_t unflushed_rows;
+      size_t unflushed_bytes;
+      std::chrono::steady_clock::time_point last_flush;
+      uint64_t flush_requests;
+      uint64_t flushes_done;
+
+      bool stopping;
+      bool detached;
+      bool closed;
+      bool failed;
+      std::string error;
+  };
+}
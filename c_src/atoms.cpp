@@ -0,0 +1,9 @@
+#include "atoms.h"
+
+nif::Atoms nif::atoms;
+
+void nif::make_atoms(ErlNifEnv* env) {
+#define NIF_ATOM_MAKE(field, atom) atoms.field = enif_make_atom(env, atom);
+  NIF_ATOMS(NIF_ATOM_MAKE)
+#undef NIF_ATOM_MAKE
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include <erl_nif.h>
+
+/*
+ * The atoms the NIF returns or compares against: X(field, "atom")
+ */
+#define NIF_ATOMS(X) \
+  X(ok, "ok") \
+  X(error, "error") \
+  X(nil, "nil") \
+  X(true_, "true") \
+  X(false_, "false") \
+  X(infinity, "infinity") \
+  X(neg_infinity, "-infinity") \
+  X(nan, "nan") \
+  X(timeout, "timeout") \
+  X(cancelled, "cancelled") \
+  X(busy, "busy") \
+  X(badarg, "badarg") \
+  X(duckdbex, "duckdbex") \
+  X(duckdbex_appender, "duckdbex_appender") \
+  X(duckdbex_telemetry, "duckdbex_telemetry") \
+  X(total, "total") \
+  X(rows, "rows") \
+  X(bytes, "bytes") \
+  X(queue, "queue") \
+  X(prepare, "prepare") \
+  X(bind, "bind") \
+  X(execute, "execute") \
+  X(fetch, "fetch") \
+  X(convert, "convert") \
+  X(append, "append") \
+  X(flush, "flush") \
+  X(query, "query") \
+  X(execute_statement, "execute_statement") \
+  X(execute_many, "execute_many") \
+  X(fetch_chunk, "fetch_chunk") \
+  X(fetch_all, "fetch_all") \
+  X(fetch_chunk_columns, "fetch_chunk_columns") \
+  X(fetch_all_columns, "fetch_all_columns") \
+  X(fetch_chunk_packed, "fetch_chunk_packed") \
+  X(appender_add_row, "appender_add_row") \
+  X(appender_add_rows, "appender_add_rows") \
+  X(appender_add_columns, "appender_add_columns") \
+  X(appender_flush, "appender_flush") \
+  X(appender_close, "appender_close") \
+  X(allocator, "allocator") \
+  X(erlang, "erlang") \
+  X(default_, "default") \
+  X(statement_cache_size, "statement_cache_size") \
+  X(stream, "stream") \
+  X(cooperative, "cooperative") \
+  X(release_on_exit, "release_on_exit") \
+  X(profile, "profile") \
+  X(transaction, "transaction") \
+  X(max_pending_rows, "max_pending_rows") \
+  X(flush_rows, "flush_rows") \
+  X(flush_bytes, "flush_bytes") \
+  X(flush_interval, "flush_interval") \
+  X(size, "size") \
+  X(capacity, "capacity") \
+  X(hits, "hits") \
+  X(misses, "misses") \
+  X(live_bytes, "live_bytes") \
+  X(peak_bytes, "peak_bytes") \
+  X(allocations, "allocations") \
+  X(extra_info, "extra_info") \
+  X(children, "children") \
+  X(name, "name") \
+  X(description, "description") \
+  X(type, "type") \
+  X(parameter_type, "parameter_type") \
+  X(scope, "scope") \
+  X(global_only, "global_only") \
+  X(global_default, "global_default") \
+  X(local_only, "local_only") \
+  X(local_default, "local_default") \
+  X(invalid, "invalid") \
+  X(boolean, "boolean") \
+  X(string, "string") \
+  X(tinyint, "tinyint") \
+  X(utinyint, "utinyint") \
+  X(smallint, "smallint") \
+  X(usmallint, "usmallint") \
+  X(integer, "integer") \
+  X(uinteger, "uinteger") \
+  X(bigint, "bigint") \
+  X(ubigint, "ubigint") \
+  X(hugeint, "hugeint") \
+  X(uhugeint, "uhugeint") \
+  X(float_, "float") \
+  X(double_, "double") \
+  X(decimal, "decimal") \
+  X(date, "date") \
+  X(time, "time") \
+  X(time_tz, "time_tz") \
+  X(timestamp, "timestamp") \
+  X(timestamp_tz, "timestamp_tz") \
+  X(timestamp_ns, "timestamp_ns") \
+  X(timestamp_ms, "timestamp_ms") \
+  X(timestamp_sec, "timestamp_sec") \
+  X(interval, "interval") \
+  X(blob, "blob") \
+  X(uuid, "uuid") \
+  X(list, "list") \
+  X(array, "array") \
+  X(map, "map") \
+  X(struct_, "struct") \
+  X(union_, "union") \
+  X(any, "any") \
+  X(unknown, "unknown")
+
+namespace nif {
+  /*
+   * The table is filled once in on_load and is the NIF priv data. The atom terms
+   * are not bound to an env, so they are read from the table directly in any env
+   * (the envs of the worker pool have no priv data).
+   * Atoms are compared by the term: `term == nif::atoms.nil`.
+   */
+  struct Atoms {
+#define NIF_ATOM_FIELD(field, atom) ERL_NIF_TERM field;
+    NIF_ATOMS(NIF_ATOM_FIELD)
+#undef NIF_ATOM_FIELD
+  };
+
+  extern Atoms atoms;
+
+  void make_atoms(ErlNifEnv* env);
+}
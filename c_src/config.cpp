@@ -1,4 +1,5 @@
 #include "config.h"
+#include "atoms.h"
 #include "term.h"
 #include "term_to_value.h"
 #include "value_to_term.h"
@@ -8,22 +9,22 @@ namespace {
   ERL_NIF_TERM scope_to_term(ErlNifEnv* env, duckdb::SettingScopeTarget scope) {
     switch (scope) {
       case duckdb::SettingScopeTarget::GLOBAL_ONLY:
-        return nif::make_atom(env, "global_only");
+        return nif::atoms.global_only;
       case duckdb::SettingScopeTarget::LOCAL_ONLY:
-        return nif::make_atom(env, "local_only");
+        return nif::atoms.local_only;
       case duckdb::SettingScopeTarget::GLOBAL_DEFAULT:
-        return nif::make_atom(env, "global_default");
+        return nif::atoms.global_default;
       case duckdb::SettingScopeTarget::LOCAL_DEFAULT:
-        return nif::make_atom(env, "local_default");
+        return nif::atoms.local_default;
       case duckdb::SettingScopeTarget::INVALID:
       default:
-        return nif::make_atom(env, "invalid");
+        return nif::atoms.invalid;
     }
   }
 
   ERL_NIF_TERM default_value_to_term(ErlNifEnv* env, const duckdb::ConfigurationOption& option) {
     if (!option.default_value)
-      return nif::make_atom(env, "nil");
+      return nif::atoms.nil;
 
     try {
       auto value_type = duckdb::DBConfig::ParseLogicalType(option.parameter_type);
@@ -63,12 +64,12 @@ ERL_NIF_TERM nif::config_option_to_term(ErlNifEnv* env, const duckdb::Configurat
 
   ERL_NIF_TERM map = enif_make_new_map(env);
 
-  enif_make_map_put(env, map, nif::make_atom(env, "name"), nif::make_binary_term(env, option.name, std::strlen(option.name)), &map);
-  enif_make_map_put(env, map, nif::make_atom(env, "type"), nif::logical_type_to_term(env, parameter_type), &map);
-  enif_make_map_put(env, map, nif::make_atom(env, "parameter_type"), nif::make_binary_term(env, option.parameter_type, std::strlen(option.parameter_type)), &map);
-  enif_make_map_put(env, map, nif::make_atom(env, "description"), nif::make_binary_term(env, option.description, std::strlen(option.description)), &map);
-  enif_make_map_put(env, map, nif::make_atom(env, "scope"), scope_to_term(env, option.scope), &map);
-  enif_make_map_put(env, map, nif::make_atom(env, "default"), default_value_to_term(env, option), &map);
+  enif_make_map_put(env, map, nif::atoms.name, nif::make_binary_term(env, option.name, std::strlen(option.name)), &map);
+  enif_make_map_put(env, map, nif::atoms.type, nif::logical_type_to_term(env, parameter_type), &map);
+  enif_make_map_put(env, map, nif::atoms.parameter_type, nif::make_binary_term(env, option.parameter_type, std::strlen(option.parameter_type)), &map);
+  enif_make_map_put(env, map, nif::atoms.description, nif::make_binary_term(env, option.description, std::strlen(option.description)), &map);
+  enif_make_map_put(env, map, nif::atoms.scope, scope_to_term(env, option.scope), &map);
+  enif_make_map_put(env, map, nif::atoms.default_, default_value_to_term(env, option), &map);
 
   return map;
 }
@@ -0,0 +1,112 @@
+#pragma once
+#include "resource.h"
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nif {
+  /*
+   * N connections to the same database. Every slot is the connection resource,
+   * so the query run on it is interrupted when the caller exits (see connection_down).
+   * The lease ends rolling back the transaction left open on the connection, the other
+   * session state (SET options, temporary tables) stays on it.
+   * The thread (scheduler) prefers its own slot, if it is busy the first idle one is taken.
+   */
+  class ConnectionPool {
+    public:
+      struct Slot {
+        std::mutex mutex;
+        erlang_resource<duckdb::Connection>* connection;
+
+        // The transaction left open by the query is rolled back before the next lease
+        void reset() {
+          if (connection->data->HasActiveTransaction())
+            connection->data->Query("ROLLBACK");
+        }
+      };
+
+      ConnectionPool(ErlNifResourceType* connection_type, duckdb::DuckDB& db, size_t size) {
+        try {
+          for (size_t i = 0; i < size; i++) {
+            ErlangResourceBuilder<duckdb::Connection> resource_builder(connection_type, db);
+
+            duckdb::unique_ptr<Slot> slot = duckdb::make_uniq<Slot>();
+            slot->connection = resource_builder.get();
+            enif_keep_resource(slot->connection);
+
+            slots.push_back(std::move(slot));
+          }
+        } catch (...) {
+          release_slots();
+          throw;
+        }
+      }
+
+      // Released while queries are running, waits for them to give the slots back
+      ~ConnectionPool() {
+        for (auto& slot : slots) {
+          slot->mutex.lock();
+          slot->mutex.unlock();
+        }
+
+        release_slots();
+      }
+
+      ConnectionPool(const ConnectionPool&) = delete;
+      ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+      size_t size() const { return slots.size(); }
+
+      /*
+       * Holds the slot locked for the scope of the query
+       */
+      class Lease {
+        public:
+          Lease(ConnectionPool& pool) : slot(pool.acquire()) {}
+          ~Lease() {
+            slot->reset();
+            slot->mutex.unlock();
+          }
+
+          Lease(const Lease&) = delete;
+          Lease& operator=(const Lease&) = delete;
+
+          erlang_resource<duckdb::Connection>* connection() { return slot->connection; }
+
+        private:
+          Slot* slot;
+      };
+
+    private:
+      void release_slots() {
+        for (auto& slot : slots)
+          enif_release_resource(slot->connection);
+        slots.clear();
+      }
+
+      Slot* acquire() {
+        size_t home = std::hash<std::thread::id>()(std::this_thread::get_id()) % slots.size();
+
+        for (size_t i = 0; i < slots.size(); i++) {
+          Slot* slot = slots[(home + i) % slots.size()].get();
+          if (slot->mutex.try_lock())
+            return slot;
+        }
+
+        // all busy, wait for the own one
+        slots[home]->mutex.lock();
+        return slots[home].get();
+      }
+
+      std::vector<duckdb::unique_ptr<Slot>> slots;
+  };
+}
+
+template <>
+inline erlang_resource<nif::ConnectionPool>* get_resource(ErlNifEnv* env, ERL_NIF_TERM term) {
+  erlang_resource<nif::ConnectionPool>* resource = nullptr;
+  if(enif_get_resource(env, term, connection_pool_nif_type, (void**)&resource) && resource->data)
+    return resource;
+  return nullptr;
+}
@@ -0,0 +1,80 @@
+#include "deadline.h"
+
+nif::DeadlineTimer::Id nif::DeadlineTimer::add(std::chrono::steady_clock::time_point at, duckdb::shared_ptr<duckdb::ClientContext> context) {
+  Id id;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!thread.joinable()) {
+      stopped = false;
+      thread = std::thread(&DeadlineTimer::run, this);
+    }
+
+    id = next_id++;
+    Deadline deadline = {at, std::move(context)};
+    deadlines.emplace(id, std::move(deadline));
+  }
+
+  condition.notify_one();
+  return id;
+}
+
+bool nif::DeadlineTimer::remove(Id id) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (deadlines.erase(id))
+    return false;
+
+  return fired.erase(id) > 0;
+}
+
+void nif::DeadlineTimer::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopped = true;
+  }
+
+  condition.notify_all();
+
+  if (thread.joinable())
+    thread.join();
+}
+
+void nif::DeadlineTimer::run() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopped) {
+    if (deadlines.empty()) {
+      condition.wait(lock);
+      continue;
+    }
+
+    auto next = deadlines.begin();
+    for (auto it = deadlines.begin(); it != deadlines.end(); ++it) {
+      if (it->second.at < next->second.at)
+        next = it;
+    }
+
+    if (std::chrono::steady_clock::now() < next->second.at) {
+      condition.wait_until(lock, next->second.at);
+      continue;
+    }
+
+    // the query can't deregister the deadline meanwhile, the mutex is held
+    next->second.context->Interrupt();
+    fired.insert(next->first);
+    deadlines.erase(next);
+  }
+}
+
+nif::QueryDeadline::QueryDeadline(DeadlineTimer& timer, unsigned long timeout_ms, duckdb::shared_ptr<duckdb::ClientContext> context)
+  : timer(timer), id(0), fired(false) {
+  if (timeout_ms)
+    id = timer.add(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms), std::move(context));
+}
+
+bool nif::QueryDeadline::expired() {
+  if (id) {
+    fired = timer.remove(id);
+    id = 0;
+  }
+
+  return fired;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "duckdb.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace nif {
+  /*
+   * The thread interrupting the queries which run past their deadlines
+   */
+  class DeadlineTimer {
+    public:
+      typedef uint64_t Id;
+
+      DeadlineTimer() : next_id(1), stopped(false) {}
+      ~DeadlineTimer() { stop(); }
+
+      DeadlineTimer(const DeadlineTimer&) = delete;
+      DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+
+      Id add(std::chrono::steady_clock::time_point at, duckdb::shared_ptr<duckdb::ClientContext> context);
+
+      // Returns true if the deadline has already fired
+      bool remove(Id id);
+
+      void stop();
+
+    private:
+      struct Deadline {
+        std::chrono::steady_clock::time_point at;
+        duckdb::shared_ptr<duckdb::ClientContext> context;
+      };
+
+      void run();
+
+      std::mutex mutex;
+      std::condition_variable condition;
+      std::map<Id, Deadline> deadlines;
+      std::set<Id> fired;
+      std::thread thread;
+      Id next_id;
+      bool stopped;
+  };
+
+  /*
+   * Registers the deadline of the query for the scope of the guard
+   */
+  class QueryDeadline {
+    public:
+      QueryDeadline(DeadlineTimer& timer, unsigned long timeout_ms, duckdb::shared_ptr<duckdb::ClientContext> context);
+      ~QueryDeadline() { expired(); }
+
+      QueryDeadline(const QueryDeadline&) = delete;
+      QueryDeadline& operator=(const QueryDeadline&) = delete;
+
+      // Deregisters the deadline, returns true if the query has been interrupted by it
+      bool expired();
+
+    private:
+      DeadlineTimer& timer;
+      DeadlineTimer::Id id;
+      bool fired;
+  };
+}
@@ -1,12 +1,27 @@
+#include "allocator.h"
+#include "async_appender.h"
+#include "atoms.h"
 #include "config.h"
+#include "connection_pool.h"
+#include "deadline.h"
+#include "profiling.h"
+#include "query_options.h"
 #include "resource.h"
+#include "telemetry.h"
 #include "term.h"
 #include "term_to_value.h"
+#include "term_to_vector.h"
 #include "value_to_term.h"
+#include "vector_to_term.h"
+#include "worker_pool.h"
 #include "duckdb.hpp"
 #include <erl_nif.h>
+#include <chrono>
 #include <string>
 
+static nif::WorkerPool worker_pool;
+static nif::DeadlineTimer deadline_timer;
+
 /*
  * DuckDB API
  */
@@ -37,8 +52,8 @@ extension_is_loaded(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
     return enif_make_badarg(env);
 
   return dbres->data->ExtensionIsLoaded(std::string((const char*)extension.data, extension.size))
-    ? nif::make_atom(env, "true")
-    : nif::make_atom(env, "false");
+    ? nif::atoms.true_
+    : nif::atoms.false_;
 }
 
 static ERL_NIF_TERM
@@ -77,11 +92,33 @@ platform(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
 
 static ERL_NIF_TERM
 create_config(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 0)
+  if (argc > 1)
     return enif_make_badarg(env);
 
+  bool erlang_allocator = false;
+  if (argc == 1) {
+    if (!enif_is_list(env, argv[0]))
+      return enif_make_badarg(env);
+
+    ERL_NIF_TERM item, items = argv[0];
+    while (enif_get_list_cell(env, items, &item, &items)) {
+      int arity = 0;
+      const ERL_NIF_TERM* option;
+      if (!enif_get_tuple(env, item, &arity, &option) || arity != 2 || option[0] != nif::atoms.allocator)
+        return enif_make_badarg(env);
+
+      if (option[1] == nif::atoms.erlang)
+        erlang_allocator = true;
+      else if (option[1] == nif::atoms.default_)
+        erlang_allocator = false;
+      else
+        return enif_make_badarg(env);
+    }
+  }
+
   try {
     ErlangResourceBuilder<duckdb::DBConfig> resource_builder(config_nif_type);
+    resource_builder.get()->erlang_allocator = erlang_allocator;
     return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
   } catch (std::exception& ex) {
     return nif::make_error_tuple(env, ex.what());
@@ -101,6 +138,8 @@ set_config_option(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!nif::get_config_name(env, argv[1], option_name))
     return enif_make_badarg(env);
 
+  std::lock_guard<std::mutex> lock(configres->mutex);
+
   duckdb::Value value;
 
   if (auto option = duckdb::DBConfig::GetOptionByName(option_name)) {
@@ -109,7 +148,7 @@ set_config_option(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
 
     try {
       configres->data->SetOption(*option, value);
-      return nif::make_atom(env, "ok");
+      return nif::atoms.ok;
     } catch (std::exception& ex) {
       return nif::make_error_tuple(env, ex.what());
     }
@@ -123,7 +162,7 @@ set_config_option(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
 
     try {
       configres->data->SetOption(extension_option.setting_index.GetIndex(), std::move(value));
-      return nif::make_atom(env, "ok");
+      return nif::atoms.ok;
     } catch (std::exception& ex) {
       return nif::make_error_tuple(env, ex.what());
     }
@@ -162,11 +201,17 @@ open(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
 
   path = std::string((const char*)arg.data, arg.size);
 
-  if (!nif::is_atom(env, argv[1], "nil")) {
+  // DuckDB moves the allocator (and the other owned parts) out of the config while opening
+  std::unique_lock<std::mutex> config_lock;
+  if (argv[1] != nif::atoms.nil) {
     auto configres = get_resource<duckdb::DBConfig>(env, argv[1]);
     if (!configres)
       return enif_make_badarg(env);
     config = configres->data.get();
+    config_lock = std::unique_lock<std::mutex>(configres->mutex);
+
+    if (configres->erlang_allocator)
+      config->allocator = nif::make_erlang_allocator();
   }
 
   try {
@@ -178,17 +223,213 @@ open(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   }
 }
 
+static ERL_NIF_TERM
+allocator_stats(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto dbres = get_resource<duckdb::DuckDB>(env, argv[0]);
+  if (!dbres)
+    return enif_make_badarg(env);
+
+  auto stats = nif::get_allocator_stats(*dbres->data->instance->config.allocator);
+  if (!stats)
+    return nif::atoms.nil;
+
+  ERL_NIF_TERM map = enif_make_new_map(env);
+  enif_make_map_put(env, map, nif::atoms.live_bytes, enif_make_uint64(env, stats->live_bytes.load()), &map);
+  enif_make_map_put(env, map, nif::atoms.peak_bytes, enif_make_uint64(env, stats->peak_bytes.load()), &map);
+  enif_make_map_put(env, map, nif::atoms.allocations, enif_make_uint64(env, stats->allocations.load()), &map);
+
+  return map;
+}
+
+//
+// The process receiving the phase timings of the NIF calls (see telemetry.h), nil removes it
+//
+static ERL_NIF_TERM
+set_telemetry_collector(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  if (argv[0] == nif::atoms.nil) {
+    nif::Telemetry::set_collector(nullptr);
+    return nif::atoms.ok;
+  }
+
+  ErlNifPid pid;
+  if (!enif_get_local_pid(env, argv[0], &pid))
+    return enif_make_badarg(env);
+
+  nif::Telemetry::set_collector(&pid);
+  return nif::atoms.ok;
+}
+
 static ERL_NIF_TERM
 connection(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   auto dbres = get_resource<duckdb::DuckDB>(env, argv[0]);
   if (!dbres)
     return enif_make_badarg(env);
 
+  unsigned long statement_cache_size = nif::StatementCache::DEFAULT_CAPACITY;
+  if (argc == 2) {
+    if (!enif_is_list(env, argv[1]))
+      return enif_make_badarg(env);
+
+    ERL_NIF_TERM item, items = argv[1];
+    while (enif_get_list_cell(env, items, &item, &items)) {
+      int arity = 0;
+      const ERL_NIF_TERM* option;
+      if (!enif_get_tuple(env, item, &arity, &option) || arity != 2)
+        return enif_make_badarg(env);
+
+      if (option[0] != nif::atoms.statement_cache_size || !enif_get_ulong(env, option[1], &statement_cache_size))
+        return enif_make_badarg(env);
+    }
+  }
+
   ErlangResourceBuilder<duckdb::Connection> resource_builder(connection_nif_type, *dbres->data);
+  resource_builder.get()->statements.resize(statement_cache_size);
+
+  return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
+}
+
+//
+// The process the async job is run for, the job env is not a process env
+//
+static thread_local const ErlNifPid* async_caller = nullptr;
+
+static bool
+get_caller(ErlNifEnv* env, ErlNifPid* pid) {
+  if (async_caller) {
+    *pid = *async_caller;
+    return true;
+  }
+
+  return enif_self(env, pid) != nullptr;
+}
+
+// NULL if called from the thread of the worker pool
+static ErlNifEnv*
+caller_env(ErlNifEnv* env) {
+  return async_caller ? nullptr : env;
+}
+
+// When the async job has been submitted, its span reports the wait in the worker pool queue
+static thread_local int64_t async_queued_at = 0;
+
+// The rows of the materialized result, the streaming one does not know them
+static uint64_t
+result_rows(duckdb::QueryResult& result) {
+  if (result.type != duckdb::QueryResultType::MATERIALIZED_RESULT || result.HasError())
+    return 0;
+
+  return static_cast<duckdb::MaterializedQueryResult&>(result).RowCount();
+}
+
+//
+// Monitors the caller on the resource and makes it the owner of the running query for the
+// scope of the query, the down callback of the resource type interrupts the query if its owner
+// exits meanwhile
+//
+class CallerMonitor {
+  public:
+    CallerMonitor(ErlNifEnv* env, void* resource, nif::QueryOwner& owner)
+      : env(caller_env(env)), resource(resource), owner(owner), active(false) {
+      ErlNifPid pid;
+      bool known = get_caller(env, &pid);
+      if (known)
+        active = !enif_monitor_process(this->env, resource, &pid, &monitor);
+
+      owner.acquire(known ? &pid : nullptr);
+    }
+
+    ~CallerMonitor() {
+      owner.release();
+      if (active)
+        enif_demonitor_process(env, resource, &monitor);
+    }
+
+    CallerMonitor(const CallerMonitor&) = delete;
+    CallerMonitor& operator=(const CallerMonitor&) = delete;
+
+  private:
+    ErlNifEnv* env;
+    void* resource;
+    nif::QueryOwner& owner;
+    ErlNifMonitor monitor;
+    bool active;
+};
+
+//
+// The interrupted query is {:error, :timeout} if its deadline has fired or {:error, :cancelled}
+//
+static ERL_NIF_TERM
+query_error_reason(ErlNifEnv* env, const duckdb::ErrorData& error, bool timed_out) {
+  if (error.Type() == duckdb::ExceptionType::INTERRUPT)
+    return timed_out ? nif::atoms.timeout : nif::atoms.cancelled;
+
+  return nif::make_binary_term(env, error.Message());
+}
+
+static ERL_NIF_TERM
+make_query_error(ErlNifEnv* env, const duckdb::ErrorData& error, bool timed_out) {
+  return nif::make_error_tuple(env, query_error_reason(env, error, timed_out));
+}
+
+//
+// With release_on_exit the result is monitoring its owner till the end,
+// the down callback releases it as soon as the owner exits. The profiling tree
+// of the profiled query is taken while the caller still holds the turn.
+//
+static ERL_NIF_TERM
+make_query_result(ErlNifEnv* env, duckdb::unique_ptr<duckdb::QueryResult> result, bool timed_out = false, bool release_on_exit = false, duckdb::ClientContext* profiled = nullptr) {
+  if (result->HasError())
+    return make_query_error(env, result->GetErrorObject(), timed_out);
+
+  ErlangResourceBuilder<duckdb::QueryResult> resource_builder(
+    query_result_nif_type,
+    std::move(result));
+
+  if (profiled)
+    resource_builder.get()->profiling_tree.capture(*profiled);
+
+  // the owner gone already (the caller of the async query) is not monitored, its result is released at once
+  ErlNifPid owner;
+  ErlNifMonitor monitor;
+  if (release_on_exit && get_caller(env, &owner) && enif_monitor_process(caller_env(env), resource_builder.get(), &owner, &monitor)) {
+    resource_builder.get()->data = nullptr;
+    return nif::make_error_tuple(env, "the owner of the result has exited");
+  }
 
   return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
 }
 
+//
+// Runs the query without parameters, the sql may contain multiple statements.
+// Streaming result is pulling chunks from the pipeline on every fetch, it becomes
+// invalid as soon as the next query is issued on the same connection.
+//
+static ERL_NIF_TERM
+run_query(ErlNifEnv* env, erlang_resource<duckdb::Connection>* connres, const std::string& sql, const nif::QueryOptions& options) {
+  nif::CallSpan span(caller_env(env), nif::atoms.query, async_queued_at);
+  CallerMonitor caller_monitor(env, connres, *connres->owner);
+  nif::QueryDeadline deadline(deadline_timer, options.timeout, connres->data->context);
+  nif::QueryProfiling profiling(*connres->profiling, *connres->data->context, options.profile);
+
+  duckdb::unique_ptr<duckdb::QueryResult> result;
+  if (options.stream)
+    result = connres->data->SendQuery(sql);
+  else
+    result = connres->data->Query(sql);
+
+  span.mark(nif::Phase::EXECUTE);
+  span.add_rows(result_rows(*result));
+
+  auto profiled = options.profile ? connres->data->context.get() : nullptr;
+  return make_query_result(env, std::move(result), deadline.expired(), options.release_on_exit, profiled);
+}
+
 static ERL_NIF_TERM
 query_without_parameters(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 2)
@@ -202,16 +443,49 @@ query_without_parameters(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!enif_inspect_binary(env, argv[1], &sql_stmt))
     return enif_make_badarg(env);
 
-  duckdb::unique_ptr<duckdb::QueryResult> result = connres->data->Query(std::string((const char*)sql_stmt.data, sql_stmt.size));
+  return run_query(env, connres, std::string((const char*)sql_stmt.data, sql_stmt.size), nif::QueryOptions());
+}
+
+//
+// The prepared statement is taken from the statement cache of the connection
+//
+static ERL_NIF_TERM
+prepare_and_query(ErlNifEnv* env, erlang_resource<duckdb::Connection>* connres, const std::string& sql, ERL_NIF_TERM args, const nif::QueryOptions& options) {
+  nif::CallSpan span(caller_env(env), nif::atoms.query, async_queued_at);
 
-  if (result->HasError())
-    return nif::make_error_tuple(env, result->GetErrorObject().Message());
+  auto statement = connres->statements.get(sql);
+  if (!statement) {
+    auto prepared = connres->data->Prepare(sql);
+    if (!prepared->success)
+      return nif::make_error_tuple(env, prepared->error.Message());
 
-  ErlangResourceBuilder<duckdb::QueryResult> resource_builder(
-    query_result_nif_type,
-    std::move(result));
+    statement = std::make_shared<nif::StatementCache::Entry>(std::move(prepared));
+    connres->statements.put(sql, statement);
+  }
 
-  return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
+  span.mark(nif::Phase::PREPARE);
+
+  duckdb::vector<duckdb::Value> query_params;
+
+  ERL_NIF_TERM error;
+  if (!statement->binder.bind(env, args, query_params, error))
+    return error;
+
+  span.mark(nif::Phase::BIND);
+
+  CallerMonitor caller_monitor(env, connres, *connres->owner);
+  nif::QueryDeadline deadline(deadline_timer, options.timeout, statement->statement->context);
+  nif::QueryProfiling profiling(*connres->profiling, *statement->statement->context, options.profile);
+  auto result = statement->statement->Execute(query_params, options.stream);
+
+  span.mark(nif::Phase::EXECUTE);
+  span.add_rows(result_rows(*result));
+
+  if (result->HasError())
+    connres->statements.remove(sql);
+
+  auto profiled = options.profile ? statement->statement->context.get() : nullptr;
+  return make_query_result(env, std::move(result), deadline.expired(), options.release_on_exit, profiled);
 }
 
 //
@@ -229,46 +503,102 @@ query_with_parameters(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!enif_inspect_binary(env, argv[1], &sql_stmt))
     return enif_make_badarg(env);
 
-  auto statement = connres->data->Prepare(std::string((const char*)sql_stmt.data, sql_stmt.size));
-  if (!statement->success)
-    return nif::make_error_tuple(env, statement->error.Message());
+  nif::QueryOptions options;
+  if (argc == 4 && !nif::term_to_query_options(env, argv[3], options))
+    return enif_make_badarg(env);
 
-  duckdb::vector<duckdb::Value> query_params;
+  std::string sql((const char*)sql_stmt.data, sql_stmt.size);
 
-  duckdb::case_insensitive_map_t<duckdb::LogicalType> params_types = statement->GetExpectedParameterTypes();
+  // no need to prepare the query without arguments
+  if (argc == 4 && enif_is_empty_list(env, argv[2]))
+    return run_query(env, connres, sql, options);
 
-  if (params_types.size()) {
-    if (argc != 3)
-      return enif_make_badarg(env);
+  return prepare_and_query(env, connres, sql, argv[2], options);
+}
 
-    if (!enif_is_list(env, argv[2]))
-      return enif_make_badarg(env);
+static ERL_NIF_TERM
+statement_cache_stats(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
 
-    ERL_NIF_TERM item, items;
-    items = argv[2];
-    int arg_idx = 0;
-    while(enif_get_list_cell(env, items, &item, &items)) {
-      duckdb::Value value;
-      auto arg_idx_str = std::to_string(arg_idx + 1);
-      if (!nif::term_to_value(env, item, params_types[arg_idx_str], value))
-        return nif::make_error_tuple(env, "invalid type of parameter #" + arg_idx_str);
-      query_params.push_back(std::move(value));
-      arg_idx++;
-    }
-  }
+  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
+  if (!connres)
+    return enif_make_badarg(env);
 
-  duckdb::unique_ptr<duckdb::QueryResult> result = statement->Execute(query_params, false);
+  auto stats = connres->statements.stats();
 
-  if (result->HasError())
-    return nif::make_error_tuple(env, result->GetErrorObject().Message());
+  ERL_NIF_TERM map = enif_make_new_map(env);
+  enif_make_map_put(env, map, nif::atoms.size, enif_make_uint64(env, stats.size), &map);
+  enif_make_map_put(env, map, nif::atoms.capacity, enif_make_uint64(env, stats.capacity), &map);
+  enif_make_map_put(env, map, nif::atoms.hits, enif_make_uint64(env, stats.hits), &map);
+  enif_make_map_put(env, map, nif::atoms.misses, enif_make_uint64(env, stats.misses), &map);
 
-  ErlangResourceBuilder<duckdb::QueryResult> resource_builder(
-    query_result_nif_type,
-    std::move(result));
+  return map;
+}
+
+static ERL_NIF_TERM
+clear_statement_cache(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
+  if (!connres)
+    return enif_make_badarg(env);
+
+  connres->statements.clear();
+
+  return nif::atoms.ok;
+}
+
+static ERL_NIF_TERM
+connection_pool(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2)
+    return enif_make_badarg(env);
+
+  auto dbres = get_resource<duckdb::DuckDB>(env, argv[0]);
+  if (!dbres)
+    return enif_make_badarg(env);
+
+  unsigned size = 0;
+  if (!enif_get_uint(env, argv[1], &size) || !size)
+    return enif_make_badarg(env);
+
+  ErlangResourceBuilder<nif::ConnectionPool> resource_builder(connection_pool_nif_type, connection_nif_type, *dbres->data, (size_t)size);
 
   return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
 }
 
+//
+// Runs the query on an idle connection of the pool. The connection goes back to the pool
+// as soon as the query is done, so the result is always materialized.
+//
+static ERL_NIF_TERM
+pool_query(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 4)
+    return enif_make_badarg(env);
+
+  auto poolres = get_resource<nif::ConnectionPool>(env, argv[0]);
+  if (!poolres)
+    return enif_make_badarg(env);
+
+  ErlNifBinary sql_stmt;
+  if (!enif_inspect_binary(env, argv[1], &sql_stmt))
+    return enif_make_badarg(env);
+
+  nif::QueryOptions options;
+  if (!enif_is_list(env, argv[2]) || !nif::term_to_query_options(env, argv[3], options) || options.stream)
+    return enif_make_badarg(env);
+
+  std::string sql((const char*)sql_stmt.data, sql_stmt.size);
+
+  nif::ConnectionPool::Lease lease(*poolres->data);
+
+  if (enif_is_empty_list(env, argv[2]))
+    return run_query(env, lease.connection(), sql, options);
+
+  return prepare_and_query(env, lease.connection(), sql, argv[2], options);
+}
+
 static ERL_NIF_TERM
 prepare_statement(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   auto connres = get_resource<duckdb::Connection>(env, argv[0]);
@@ -287,6 +617,9 @@ prepare_statement(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
     prepared_statement_nif_type,
     std::move(statement));
 
+  resource_builder.get()->owner = connres->owner;
+  resource_builder.get()->profiling = connres->profiling;
+
   return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
 }
 
@@ -296,39 +629,129 @@ execute_statement(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!stmtres)
     return enif_make_badarg(env);
 
+  nif::QueryOptions options;
+  if (argc == 3 && !nif::term_to_query_options(env, argv[2], options))
+    return enif_make_badarg(env);
+
+  nif::CallSpan span(caller_env(env), nif::atoms.execute_statement, async_queued_at);
+
   duckdb::vector<duckdb::Value> query_params;
-  duckdb::case_insensitive_map_t<duckdb::LogicalType> params_types = stmtres->data->GetExpectedParameterTypes();
 
-  if (params_types.size()) {
-    if (argc != 2)
+  if (stmtres->binder.size()) {
+    if (argc < 2)
       return enif_make_badarg(env);
 
-    if (!enif_is_list(env, argv[1]))
-      return enif_make_badarg(env);
+    ERL_NIF_TERM error;
+    if (!stmtres->binder.bind(env, argv[1], query_params, error))
+      return error;
+  }
 
-    ERL_NIF_TERM item, items;
-    items = argv[1];
-    int arg_idx = 0;
-    while(enif_get_list_cell(env, items, &item, &items)) {
-      duckdb::Value value;
-      auto arg_idx_str = std::to_string(arg_idx + 1);
-      if (!nif::term_to_value(env, item, params_types[arg_idx_str], value))
-        return nif::make_error_tuple(env, "invalid type of parameter #" + arg_idx_str);
-      query_params.push_back(std::move(value));
-      arg_idx++;
-    }
+  span.mark(nif::Phase::BIND);
+
+  CallerMonitor caller_monitor(env, stmtres, *stmtres->owner);
+  nif::QueryDeadline deadline(deadline_timer, options.timeout, stmtres->data->context);
+  nif::QueryProfiling profiling(*stmtres->profiling, *stmtres->data->context, options.profile);
+  auto result = stmtres->data->Execute(query_params, options.stream);
+
+  span.mark(nif::Phase::EXECUTE);
+  span.add_rows(result_rows(*result));
+
+  auto profiled = options.profile ? stmtres->data->context.get() : nullptr;
+  return make_query_result(env, std::move(result), deadline.expired(), options.release_on_exit, profiled);
+}
+
+//
+// Rolls back the transaction opened by execute_statement_many and returns {:error, {row, reason}}
+//
+static ERL_NIF_TERM
+execute_many_error(ErlNifEnv* env, duckdb::ClientContext& context, bool own_transaction, unsigned row, ERL_NIF_TERM reason) {
+  if (own_transaction)
+    context.Query("ROLLBACK", false);
+
+  return nif::make_error_tuple(env, enif_make_tuple2(env, enif_make_uint(env, row), reason));
+}
+
+//
+// Executes the statement for every row of the arguments in one call, stops at the first
+// failing row (its index is zero based). `transaction: true` runs the rows in one transaction
+// unless the connection has already opened one, on failure it is rolled back.
+// Returns the total number of the rows changed by the statement.
+//
+static ERL_NIF_TERM
+execute_statement_many(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 3)
+    return enif_make_badarg(env);
+
+  auto stmtres = get_resource<duckdb::PreparedStatement>(env, argv[0]);
+  if (!stmtres)
+    return enif_make_badarg(env);
+
+  if (!enif_is_list(env, argv[1]))
+    return enif_make_badarg(env);
+
+  nif::ExecuteManyOptions options;
+  if (!nif::term_to_execute_many_options(env, argv[2], options))
+    return enif_make_badarg(env);
+
+  auto& context = *stmtres->data->context;
+
+  nif::CallSpan span(caller_env(env), nif::atoms.execute_many);
+  CallerMonitor caller_monitor(env, stmtres, *stmtres->owner);
+  nif::QueryDeadline deadline(deadline_timer, options.timeout, stmtres->data->context);
+
+  // the transaction NIFs and the queries take the owner's turn too, so nothing opens or
+  // closes the transaction between the check and the BEGIN
+  bool own_transaction = options.transaction && context.transaction.IsAutoCommit();
+  if (own_transaction) {
+    auto begin = context.Query("BEGIN TRANSACTION", false);
+    if (begin->HasError())
+      return make_query_error(env, begin->GetErrorObject(), deadline.expired());
+
+    span.mark(nif::Phase::EXECUTE);
   }
 
-  duckdb::unique_ptr<duckdb::QueryResult> result = stmtres->data->Execute(query_params);
+  int64_t changed_rows = 0;
+  duckdb::vector<duckdb::Value> query_params;
 
-  if (result->HasError())
-    return nif::make_error_tuple(env, result->GetErrorObject().Message());
+  ERL_NIF_TERM row, rows = argv[1];
+  unsigned row_idx = 0;
+  while (enif_get_list_cell(env, rows, &row, &rows)) {
+    query_params.clear();
 
-  ErlangResourceBuilder<duckdb::QueryResult> resource_builder(
-    query_result_nif_type,
-    std::move(result));
+    ERL_NIF_TERM reason;
+    auto status = enif_is_list(env, row) ? stmtres->binder.bind_params(env, row, query_params, reason) : nif::ParamsBinder::Status::BADARG;
+    if (status != nif::ParamsBinder::Status::OK) {
+      if (status == nif::ParamsBinder::Status::INVALID_PARAM)
+        return execute_many_error(env, context, own_transaction, row_idx, reason);
 
-  return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
+      if (own_transaction)
+        context.Query("ROLLBACK", false);
+      return enif_make_badarg(env);
+    }
+
+    span.mark(nif::Phase::BIND);
+    auto result = stmtres->data->Execute(query_params, false);
+    span.mark(nif::Phase::EXECUTE);
+    if (result->HasError())
+      return execute_many_error(env, context, own_transaction, row_idx,
+        query_error_reason(env, result->GetErrorObject(), deadline.expired()));
+
+    if (result->properties.return_type == duckdb::StatementReturnType::CHANGED_ROWS)
+      changed_rows += static_cast<duckdb::MaterializedQueryResult&>(*result).GetValue<int64_t>(0, 0);
+
+    row_idx++;
+    span.add_rows(1);
+  }
+
+  if (own_transaction) {
+    auto commit = context.Query("COMMIT", false);
+    if (commit->HasError())
+      return make_query_error(env, commit->GetErrorObject(), deadline.expired());
+
+    span.mark(nif::Phase::EXECUTE);
+  }
+
+  return nif::make_ok_tuple(env, enif_make_int64(env, changed_rows));
 }
 
 static ERL_NIF_TERM
@@ -340,11 +763,12 @@ begin_transaction(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!connres)
     return enif_make_badarg(env);
 
+  nif::QueryOwner::Turn turn(*connres->owner);
   duckdb::unique_ptr<duckdb::QueryResult> result = connres->data->Query("BEGIN TRANSACTION");
   if (result->HasError())
     return nif::make_error_tuple(env, result->GetErrorObject().Message());
 
-  return nif::make_atom(env, "ok");
+  return nif::atoms.ok;
 }
 
 static ERL_NIF_TERM
@@ -356,11 +780,12 @@ commit(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!connres)
     return enif_make_badarg(env);
 
+  nif::QueryOwner::Turn turn(*connres->owner);
   duckdb::unique_ptr<duckdb::QueryResult> result = connres->data->Query("COMMIT");
   if (result->HasError())
     return nif::make_error_tuple(env, result->GetErrorObject().Message());
 
-  return nif::make_atom(env, "ok");
+  return nif::atoms.ok;
 }
 
 static ERL_NIF_TERM
@@ -372,11 +797,12 @@ rollback(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!connres)
     return enif_make_badarg(env);
 
+  nif::QueryOwner::Turn turn(*connres->owner);
   duckdb::unique_ptr<duckdb::QueryResult> result = connres->data->Query("ROLLBACK");
   if (result->HasError())
     return nif::make_error_tuple(env, result->GetErrorObject().Message());
 
-  return nif::make_atom(env, "ok");
+  return nif::atoms.ok;
 }
 
 static ERL_NIF_TERM
@@ -392,9 +818,10 @@ set_auto_commit(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!nif::term_to_boolean(env, argv[1], boolean))
     return enif_make_badarg(env);
 
+  nif::QueryOwner::Turn turn(*connres->owner);
   connres->data->SetAutoCommit(duckdb::BooleanValue::Get(boolean));
 
-  return nif::make_atom(env, "ok");
+  return nif::atoms.ok;
 }
 
 static ERL_NIF_TERM
@@ -406,7 +833,7 @@ is_auto_commit(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!connres)
     return enif_make_badarg(env);
 
-  return nif::make_ok_tuple(env, nif::make_atom(env, connres->data->IsAutoCommit() ? "true" : "false"));
+  return nif::make_ok_tuple(env, nif::boolean_to_term(env, connres->data->IsAutoCommit()));
 }
 
 static ERL_NIF_TERM
@@ -418,294 +845,1217 @@ has_active_transaction(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (!connres)
     return enif_make_badarg(env);
 
-  return nif::make_ok_tuple(env, nif::make_atom(env, connres->data->HasActiveTransaction() ? "true" : "false"));
+  return nif::make_ok_tuple(env, nif::boolean_to_term(env, connres->data->HasActiveTransaction()));
 }
 
 static ERL_NIF_TERM
-columns(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+enable_profiling(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1)
     return enif_make_badarg(env);
 
-  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
-  if (!result)
+  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
+  if (!connres)
     return enif_make_badarg(env);
 
-  if (result->data->HasError()) {
-    auto error = result->data->GetError();
-    return nif::make_error_tuple(env, error);
-  }
+  connres->profiling->enable(*connres->data->context);
 
-  if (duckdb::idx_t columns_count = result->data->ColumnCount()) {
-    std::vector<ERL_NIF_TERM> columns(columns_count);
-    for (duckdb::idx_t col = 0; col < columns_count; col++) {
-      duckdb::string column_name = result->data->ColumnName(col);
-      columns[col] = nif::make_binary_term(env, column_name);
-    }
-    return enif_make_list_from_array(env, &columns[0], columns.size());
-  } else {
-    return enif_make_list(env, 0);
-  }
+  return nif::atoms.ok;
 }
 
 static ERL_NIF_TERM
-fetch_chunk(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+disable_profiling(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1)
     return enif_make_badarg(env);
 
-  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
-  if (!result)
+  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
+  if (!connres)
     return enif_make_badarg(env);
 
-  if (result->data->HasError()) {
-    auto error = result->data->GetError();
+  connres->profiling->disable(*connres->data->context);
+
+  return nif::atoms.ok;
+}
+
+//
+// The profiling tree of the query result run with profile: true, or of the last query
+// profiled on the connection (or on the connection of the prepared statement), nil when
+// there is none. The next profiled query restarts the profiler of the connection, the tree
+// of the connection is converted while the turn of its queries is held.
+//
+static ERL_NIF_TERM
+profiling_tree(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  if (auto result = get_resource<duckdb::QueryResult>(env, argv[0]))
+    return result->profiling_tree.get(env);
+
+  duckdb::shared_ptr<duckdb::ClientContext> context;
+  std::shared_ptr<nif::QueryOwner> owner;
+  if (auto connres = get_resource<duckdb::Connection>(env, argv[0])) {
+    context = connres->data->context;
+    owner = connres->owner;
+  } else if (auto stmtres = get_resource<duckdb::PreparedStatement>(env, argv[0])) {
+    context = stmtres->data->context;
+    owner = stmtres->owner;
+  } else {
+    return enif_make_badarg(env);
+  }
+
+  nif::QueryOwner::Turn turn(*owner);
+
+  auto tree = context->GetProfilingTree();
+  if (!tree)
+    return nif::atoms.nil;
+
+  return nif::profiling_node_to_term(env, *tree);
+}
+
+static ERL_NIF_TERM
+columns(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
+  if (!result)
+    return enif_make_badarg(env);
+
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (!result->data)
+    return enif_make_badarg(env);
+
+  if (result->data->HasError()) {
+    auto error = result->data->GetError();
+    return nif::make_error_tuple(env, error);
+  }
+
+  if (duckdb::idx_t columns_count = result->data->ColumnCount()) {
+    std::vector<ERL_NIF_TERM> columns(columns_count);
+    for (duckdb::idx_t col = 0; col < columns_count; col++) {
+      columns[col] = nif::make_binary_term(env, result->data->ColumnName(col));
+    }
+    return enif_make_list_from_array(env, &columns[0], columns.size());
+  } else {
+    return enif_make_list(env, 0);
+  }
+}
+
+static ERL_NIF_TERM
+make_convert_error(ErlNifEnv* env, const duckdb::Vector& vector) {
+  return nif::make_error_tuple(env, "Can't convert DuckDB value of type '" + vector.GetType().ToString() + "' to the Erlang term.");
+}
+
+/*
+ * Converts the chunk column by column (see vector_to_term.h) into the row-major
+ * `cells` (the scratch of the result, it keeps its capacity between the chunks).
+ */
+static bool
+chunk_to_cells(ErlNifEnv* env, duckdb::DataChunk& chunk, std::vector<ERL_NIF_TERM>& cells, ERL_NIF_TERM& error) {
+  duckdb::idx_t rows_count = chunk.size();
+  duckdb::idx_t columns_count = chunk.ColumnCount();
+
+  cells.resize(rows_count * columns_count);
+
+  for (duckdb::idx_t col = 0; col < columns_count; col++) {
+    if (!nif::vector_to_terms(env, chunk.data[col], rows_count, &cells[col], columns_count)) {
+      error = make_convert_error(env, chunk.data[col]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*
+ * Builds the rows of the converted chunk as lists and conses them onto `tail`
+ */
+static ERL_NIF_TERM
+cells_to_rows(ErlNifEnv* env, const std::vector<ERL_NIF_TERM>& cells, duckdb::idx_t columns_count, ERL_NIF_TERM tail) {
+  if (!columns_count)
+    return tail;
+
+  for (duckdb::idx_t row = cells.size() / columns_count; row > 0; row--)
+    tail = enif_make_list_cell(env, enif_make_list_from_array(env, &cells[(row - 1) * columns_count], columns_count), tail);
+
+  return tail;
+}
+
+/*
+ * Appends the chunk rows as lists to the `rows`
+ */
+static bool
+chunk_to_rows(ErlNifEnv* env, duckdb::DataChunk& chunk, std::vector<ERL_NIF_TERM>& cells, std::vector<ERL_NIF_TERM>& rows, ERL_NIF_TERM& error) {
+  duckdb::idx_t rows_count = chunk.size();
+  duckdb::idx_t columns_count = chunk.ColumnCount();
+
+  if (!rows_count || !columns_count)
+    return true;
+
+  if (!chunk_to_cells(env, chunk, cells, error))
+    return false;
+
+  rows.reserve(rows.size() + rows_count);
+  for (duckdb::idx_t row = 0; row < rows_count; row++)
+    rows.push_back(enif_make_list_from_array(env, &cells[row * columns_count], columns_count));
+
+  return true;
+}
+
+//
+// The streaming result runs the query while it is fetched, so the fetch fails with the error
+// of the query, {:error, :cancelled} when it is interrupted by cancel/1
+//
+static bool
+try_fetch(duckdb::QueryResult& result, duckdb::unique_ptr<duckdb::DataChunk>& chunk, duckdb::ErrorData& error) {
+  if (result.TryFetch(chunk, error) && !error.HasError())
+    return true;
+
+  if (!error.HasError())
+    error = duckdb::ErrorData("failed to fetch the result");
+
+  return false;
+}
+
+static ERL_NIF_TERM
+fetch_chunk(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
+  if (!result)
+    return enif_make_badarg(env);
+
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (!result->data)
+    return enif_make_badarg(env);
+
+  if (result->data->HasError()) {
+    auto error = result->data->GetError();
+    return nif::make_error_tuple(env, error);
+  }
+
+  nif::CallSpan span(caller_env(env), nif::atoms.fetch_chunk, async_queued_at);
+
+  duckdb::unique_ptr<duckdb::DataChunk> chunk;
+  duckdb::ErrorData error;
+  if (!try_fetch(*result->data, chunk, error))
+    return make_query_error(env, error, false);
+
+  span.mark(nif::Phase::FETCH);
+
+  if (!chunk || !chunk->size())
+    return enif_make_list(env, 0);
+
+  ERL_NIF_TERM convert_error;
+  if (!chunk_to_cells(env, *chunk, result->cells, convert_error))
+    return convert_error;
+
+  ERL_NIF_TERM rows = cells_to_rows(env, result->cells, chunk->ColumnCount(), enif_make_list(env, 0));
+
+  span.mark(nif::Phase::CONVERT);
+  span.add_rows(chunk->size());
+  span.add_bytes(chunk->GetAllocationSize());
+
+  return rows;
+}
+
+static ERL_NIF_TERM
+fetch_all(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
+  if (!result)
+    return enif_make_badarg(env);
+
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (!result->data)
+    return enif_make_badarg(env);
+
+  if (result->data->HasError()) {
+    auto error = result->data->GetError();
+    return nif::make_error_tuple(env, error);
+  }
+
+  // the materialized result knows the number of rows to fetch
+  std::vector<ERL_NIF_TERM> rows;
+  if (result->data->type == duckdb::QueryResultType::MATERIALIZED_RESULT)
+    rows.reserve(static_cast<duckdb::MaterializedQueryResult&>(*result->data).RowCount());
+
+  nif::CallSpan span(caller_env(env), nif::atoms.fetch_all, async_queued_at);
+
+  duckdb::unique_ptr<duckdb::DataChunk> chunk;
+  duckdb::ErrorData error;
+  bool fetched;
+  while ((fetched = try_fetch(*result->data, chunk, error)) && chunk) {
+    span.mark(nif::Phase::FETCH);
+
+    ERL_NIF_TERM convert_error;
+    if (!chunk_to_rows(env, *chunk, result->cells, rows, convert_error))
+      return convert_error;
+
+    span.mark(nif::Phase::CONVERT);
+    span.add_rows(chunk->size());
+    span.add_bytes(chunk->GetAllocationSize());
+  }
+
+  if (!fetched)
+    return make_query_error(env, error, false);
+
+  if (rows.size())
+    return enif_make_list_from_array(env, &rows[0], rows.size());
+  else
+    return enif_make_list(env, 0);
+}
+
+/*
+ * Appends the chunk values of every column to the corresponding `columns` item.
+ */
+static bool
+chunk_to_columns(ErlNifEnv* env, duckdb::DataChunk& chunk, std::vector<std::vector<ERL_NIF_TERM>>& columns, ERL_NIF_TERM& error) {
+  duckdb::idx_t rows_count = chunk.size();
+
+  if (!rows_count)
+    return true;
+
+  for (duckdb::idx_t col = 0; col < columns.size(); col++) {
+    std::vector<ERL_NIF_TERM>& cells = columns[col];
+    size_t offset = cells.size();
+
+    cells.resize(offset + rows_count);
+    if (!nif::vector_to_terms(env, chunk.data[col], rows_count, &cells[offset], 1)) {
+      error = make_convert_error(env, chunk.data[col]);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static ERL_NIF_TERM
+make_columns_term(ErlNifEnv* env, const std::vector<std::vector<ERL_NIF_TERM>>& columns) {
+  if (columns.empty())
+    return enif_make_list(env, 0);
+
+  std::vector<ERL_NIF_TERM> lists(columns.size());
+  for (size_t col = 0; col < columns.size(); col++) {
+    lists[col] = columns[col].size()
+      ? enif_make_list_from_array(env, &columns[col][0], columns[col].size())
+      : enif_make_list(env, 0);
+  }
+
+  return enif_make_list_from_array(env, &lists[0], lists.size());
+}
+
+static ERL_NIF_TERM
+fetch_chunk_columns(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
+  if (!result)
+    return enif_make_badarg(env);
+
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (!result->data)
+    return enif_make_badarg(env);
+
+  if (result->data->HasError()) {
+    auto error = result->data->GetError();
+    return nif::make_error_tuple(env, error);
+  }
+
+  nif::CallSpan span(caller_env(env), nif::atoms.fetch_chunk_columns);
+
+  duckdb::unique_ptr<duckdb::DataChunk> chunk;
+  duckdb::ErrorData error;
+  if (!try_fetch(*result->data, chunk, error))
+    return make_query_error(env, error, false);
+
+  span.mark(nif::Phase::FETCH);
+
+  if (!chunk || !chunk->size())
+    return enif_make_list(env, 0);
+
+  std::vector<std::vector<ERL_NIF_TERM>> columns(chunk->ColumnCount());
+
+  ERL_NIF_TERM convert_error;
+  if (!chunk_to_columns(env, *chunk, columns, convert_error))
+    return convert_error;
+
+  ERL_NIF_TERM columns_term = make_columns_term(env, columns);
+
+  span.mark(nif::Phase::CONVERT);
+  span.add_rows(chunk->size());
+  span.add_bytes(chunk->GetAllocationSize());
+
+  return columns_term;
+}
+
+static ERL_NIF_TERM
+fetch_all_columns(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
+  if (!result)
+    return enif_make_badarg(env);
+
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (!result->data)
+    return enif_make_badarg(env);
+
+  if (result->data->HasError()) {
+    auto error = result->data->GetError();
+    return nif::make_error_tuple(env, error);
+  }
+
+  std::vector<std::vector<ERL_NIF_TERM>> columns(result->data->ColumnCount());
+  if (result->data->type == duckdb::QueryResultType::MATERIALIZED_RESULT) {
+    for (auto& cells : columns)
+      cells.reserve(static_cast<duckdb::MaterializedQueryResult&>(*result->data).RowCount());
+  }
+
+  nif::CallSpan span(caller_env(env), nif::atoms.fetch_all_columns);
+
+  duckdb::unique_ptr<duckdb::DataChunk> chunk;
+  duckdb::ErrorData error;
+  bool fetched;
+  while ((fetched = try_fetch(*result->data, chunk, error)) && chunk) {
+    span.mark(nif::Phase::FETCH);
+
+    ERL_NIF_TERM convert_error;
+    if (!chunk_to_columns(env, *chunk, columns, convert_error))
+      return convert_error;
+
+    span.mark(nif::Phase::CONVERT);
+    span.add_rows(chunk->size());
+    span.add_bytes(chunk->GetAllocationSize());
+  }
+
+  if (!fetched)
+    return make_query_error(env, error, false);
+
+  return make_columns_term(env, columns);
+}
+
+static ERL_NIF_TERM
+fetch_chunk_packed(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
+  if (!result)
+    return enif_make_badarg(env);
+
+  std::lock_guard<std::mutex> lock(result->mutex);
+  if (!result->data)
+    return enif_make_badarg(env);
+
+  if (result->data->HasError()) {
+    auto error = result->data->GetError();
+    return nif::make_error_tuple(env, error);
+  }
+
+  nif::CallSpan span(caller_env(env), nif::atoms.fetch_chunk_packed);
+
+  duckdb::unique_ptr<duckdb::DataChunk> chunk;
+  duckdb::ErrorData error;
+  if (!try_fetch(*result->data, chunk, error))
+    return make_query_error(env, error, false);
+
+  span.mark(nif::Phase::FETCH);
+
+  if (!chunk || !chunk->size())
+    return enif_make_list(env, 0);
+
+  duckdb::idx_t columns_count = chunk->ColumnCount();
+  std::vector<ERL_NIF_TERM> columns(columns_count);
+
+  for (duckdb::idx_t col = 0; col < columns_count; col++) {
+    if (!nif::vector_to_packed_term(env, chunk->data[col], chunk->size(), columns[col]))
+      return make_convert_error(env, chunk->data[col]);
+  }
+
+  span.mark(nif::Phase::CONVERT);
+  span.add_rows(chunk->size());
+  span.add_bytes(chunk->GetAllocationSize());
+
+  return enif_make_list_from_array(env, &columns[0], columns.size());
+}
+
+static ERL_NIF_TERM
+appender(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc < 2 || argc > 3) {
+    return enif_make_badarg(env);
+  }
+
+  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
+  if (!connres)
+    return enif_make_badarg(env);
+
+  ErlNifBinary binary_table_name;
+  if (argc == 2) {
+    // Only table name is provided
+    if (!enif_inspect_binary(env, argv[1], &binary_table_name)) {
+      return enif_make_badarg(env);
+    }
+
+    std::string table_name((const char*)binary_table_name.data, binary_table_name.size);
+
+    if (!connres->data->TableInfo(table_name))
+      return nif::make_error_tuple(env, "Table '" + table_name + "' could not be found");
+
+    ErlangResourceBuilder<duckdb::Appender> resource_builder(appender_nif_type, *connres->data, table_name);
+    return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
+  } else {
+    ErlNifBinary binary_schema_name;
+
+    // Schema name and table name are provided
+    if (!enif_inspect_binary(env, argv[1], &binary_schema_name)) {
+      return enif_make_badarg(env);
+    }
+    if (!enif_inspect_binary(env, argv[2], &binary_table_name)) {
+      return enif_make_badarg(env);
+    }
+
+    std::string schema_name((const char*)binary_schema_name.data, binary_schema_name.size);
+    std::string table_name((const char*)binary_table_name.data, binary_table_name.size);
+
+    if (!connres->data->TableInfo(schema_name, table_name)) {
+      return nif::make_error_tuple(env, "Table '" + schema_name + "." + table_name + "' could not be found");
+    }
+
+    ErlangResourceBuilder<duckdb::Appender> resource_builder(appender_nif_type, *connres->data, schema_name, table_name);
+    return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
+  }
+}
+
+static ERL_NIF_TERM
+appender_add_row(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2)
+    return enif_make_badarg(env);
+
+  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
+  if (!apres)
+    return enif_make_badarg(env);
+
+  if (!enif_is_list(env, argv[1]))
+    return enif_make_badarg(env);
+
+  unsigned row_size = 0;
+  if(!enif_get_list_length(env, argv[1], &row_size) || row_size != apres->writer.size())
+    return enif_make_badarg(env);
+
+  nif::CallSpan span(env, nif::atoms.appender_add_row);
+
+  std::string error;
+  if (!apres->writer.append_row(env, *apres->data, argv[1], error))
+    return nif::make_error_tuple(env, error);
+
+  span.mark(nif::Phase::APPEND);
+  span.add_rows(1);
+
+  return nif::atoms.ok;
+}
+
+static ERL_NIF_TERM
+appender_add_rows(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2)
+    return enif_make_badarg(env);
+
+  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
+  if (!apres)
+    return enif_make_badarg(env);
+
+  if (!enif_is_list(env, argv[1]))
+    return enif_make_badarg(env);
+
+  nif::CallSpan span(env, nif::atoms.appender_add_rows);
+
+  ERL_NIF_TERM row, rows;
+  rows = argv[1];
+  std::string error;
+  while(enif_get_list_cell(env, rows, &row, &rows)) {
+    if (!enif_is_list(env, row))
+      return enif_make_badarg(env);
+
+    unsigned row_size = 0;
+    if(!enif_get_list_length(env, row, &row_size) || row_size != apres->writer.size())
+      return enif_make_badarg(env);
+
+    if (!apres->writer.append_row(env, *apres->data, row, error))
+      return nif::make_error_tuple(env, error);
+
+    span.add_rows(1);
+  }
+
+  span.mark(nif::Phase::APPEND);
+
+  return nif::atoms.ok;
+}
+
+//
+// Takes the list of the columns (a list of values or the packed binary each, see
+// nif::ColumnSource, all of the same length). The columns are written into the DataChunk
+// by STANDARD_VECTOR_SIZE rows and the chunk is appended at once, the chunks before
+// the failed one are already appended.
+//
+static ERL_NIF_TERM
+appender_add_columns(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2)
+    return enif_make_badarg(env);
+
+  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
+  if (!apres)
+    return enif_make_badarg(env);
+
+  const duckdb::vector<duckdb::LogicalType>& types = apres->data->GetActiveTypes();
+
+  unsigned columns_count = 0;
+  if (!enif_get_list_length(env, argv[1], &columns_count) || columns_count != types.size())
+    return enif_make_badarg(env);
+
+  std::vector<nif::ColumnSource> columns(columns_count);
+
+  size_t rows_count = 0;
+  ERL_NIF_TERM column, items = argv[1];
+  for (size_t column_idx = 0; enif_get_list_cell(env, items, &column, &items); column_idx++) {
+    if (!columns[column_idx].init(env, column, types[column_idx]))
+      return enif_make_badarg(env);
+
+    if (column_idx && columns[column_idx].size() != rows_count)
+      return enif_make_badarg(env);
+
+    rows_count = columns[column_idx].size();
+  }
+
+  nif::CallSpan span(env, nif::atoms.appender_add_columns);
+
+  duckdb::DataChunk chunk;
+  chunk.Initialize(duckdb::Allocator::DefaultAllocator(), types);
+
+  for (duckdb::idx_t offset = 0; offset < rows_count; offset += STANDARD_VECTOR_SIZE) {
+    duckdb::idx_t count = std::min<duckdb::idx_t>(STANDARD_VECTOR_SIZE, rows_count - offset);
+
+    chunk.Reset();
+    for (size_t column_idx = 0; column_idx < columns.size(); column_idx++) {
+      if (!columns[column_idx].read(env, chunk.data[column_idx], count))
+        return nif::make_error_tuple(env, "invalid type of column: " + std::to_string(column_idx));
+    }
+
+    chunk.SetCardinality(count);
+    span.mark(nif::Phase::CONVERT);
+
+    // the conversion and constraint errors of the chunk are thrown
+    try {
+      apres->data->AppendDataChunk(chunk);
+    } catch (std::exception& ex) {
+      return nif::make_error_tuple(env, ex.what());
+    }
+
+    span.mark(nif::Phase::APPEND);
+    span.add_rows(count);
+    span.add_bytes(chunk.GetAllocationSize());
+  }
+
+  return nif::atoms.ok;
+}
+
+static ERL_NIF_TERM
+appender_flush(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
+  if (!apres)
+    return enif_make_badarg(env);
+
+  nif::CallSpan span(env, nif::atoms.appender_flush);
+
+  apres->data->Flush();
+
+  span.mark(nif::Phase::FLUSH);
+
+  return nif::atoms.ok;
+}
+
+static ERL_NIF_TERM
+appender_close(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
+  if (!apres)
+    return enif_make_badarg(env);
+
+  nif::CallSpan span(env, nif::atoms.appender_close);
+
+  apres->data->Close();
+  apres->data = nullptr;
+
+  span.mark(nif::Phase::FLUSH);
+
+  return nif::atoms.ok;
+}
+
+/*
+ * Async appender
+ *
+ * The thread of the appender keeps the resource till it exits, the appender is closed
+ * by async_appender_close or, with the queued rows appended, when its owner exits.
+ * The failure is sent to the owner as {:duckdbex_appender, appender, {:error, reason}}.
+ */
+
+static ERL_NIF_TERM
+async_appender(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 4)
+    return enif_make_badarg(env);
+
+  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
+  if (!connres)
+    return enif_make_badarg(env);
+
+  std::string schema_name;
+  ErlNifBinary binary_schema_name;
+  if (enif_inspect_binary(env, argv[1], &binary_schema_name))
+    schema_name = std::string((const char*)binary_schema_name.data, binary_schema_name.size);
+  else if (argv[1] != nif::atoms.nil)
+    return enif_make_badarg(env);
+
+  ErlNifBinary binary_table_name;
+  if (!enif_inspect_binary(env, argv[2], &binary_table_name))
+    return enif_make_badarg(env);
+
+  std::string table_name((const char*)binary_table_name.data, binary_table_name.size);
+
+  nif::AsyncAppenderOptions options;
+  if (!nif::term_to_async_appender_options(env, argv[3], options))
+    return enif_make_badarg(env);
+
+  if (schema_name.empty() && !connres->data->TableInfo(table_name))
+    return nif::make_error_tuple(env, "Table '" + table_name + "' could not be found");
+
+  if (!schema_name.empty() && !connres->data->TableInfo(schema_name, table_name))
+    return nif::make_error_tuple(env, "Table '" + schema_name + "." + table_name + "' could not be found");
+
+  auto appender = schema_name.empty()
+    ? duckdb::make_uniq<duckdb::Appender>(*connres->data, table_name)
+    : duckdb::make_uniq<duckdb::Appender>(*connres->data, schema_name, table_name);
+
+  ErlangResourceBuilder<nif::AsyncAppender> resource_builder(async_appender_nif_type, std::move(appender), options);
+  auto resource = resource_builder.get();
+
+  ErlNifPid owner;
+  enif_self(env, &owner);
+
+  ErlNifMonitor monitor;
+  enif_monitor_process(env, resource, &owner, &monitor);
+
+  enif_keep_resource(resource);
+  resource->data->start(
+    [resource, owner](const std::string& error) {
+      ErlNifEnv* msg_env = enif_alloc_env();
+      ERL_NIF_TERM msg = enif_make_tuple3(msg_env,
+        nif::atoms.duckdbex_appender,
+        enif_make_resource(msg_env, resource),
+        nif::make_error_tuple(msg_env, error));
+
+      ErlNifPid to = owner;
+      enif_send(NULL, &to, msg_env, msg);
+      enif_free_env(msg_env);
+    },
+    [resource]() {
+      enif_release_resource(resource);
+    });
+
+  return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
+}
+
+//
+// Returns {:error, :busy} when the queue of the appender is full
+//
+static ERL_NIF_TERM
+async_appender_add_rows(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 2)
+    return enif_make_badarg(env);
+
+  auto apres = get_resource<nif::AsyncAppender>(env, argv[0], async_appender_nif_type);
+  if (!apres)
+    return enif_make_badarg(env);
+
+  unsigned rows_count = 0;
+  if (!enif_get_list_length(env, argv[1], &rows_count))
+    return enif_make_badarg(env);
+
+  ERL_NIF_TERM row, rows = argv[1];
+  while (enif_get_list_cell(env, rows, &row, &rows)) {
+    unsigned row_size = 0;
+    if (!enif_get_list_length(env, row, &row_size) || row_size != apres->data->columns_count())
+      return enif_make_badarg(env);
+  }
+
+  if (!rows_count)
+    return nif::atoms.ok;
+
+  ErlNifEnv* rows_env = enif_alloc_env();
+  ERL_NIF_TERM rows_copy = enif_make_copy(rows_env, argv[1]);
+
+  std::string error;
+  switch (apres->data->add(rows_env, rows_copy, rows_count, error)) {
+    case nif::AsyncAppender::ADDED:
+      return nif::atoms.ok;
+    case nif::AsyncAppender::BUSY:
+      enif_free_env(rows_env);
+      return nif::make_error_tuple(env, nif::atoms.busy);
+    case nif::AsyncAppender::FAILED:
+      enif_free_env(rows_env);
+      return nif::make_error_tuple(env, error);
+    default:
+      enif_free_env(rows_env);
+      return nif::make_error_tuple(env, "appender is closed");
+  }
+}
+
+static ERL_NIF_TERM
+async_appender_flush(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
+
+  auto apres = get_resource<nif::AsyncAppender>(env, argv[0], async_appender_nif_type);
+  if (!apres)
+    return enif_make_badarg(env);
+
+  std::string error;
+  if (!apres->data->flush(error))
     return nif::make_error_tuple(env, error);
-  }
 
-  std::vector<ERL_NIF_TERM> rows;
+  return nif::atoms.ok;
+}
 
-  duckdb::unique_ptr<duckdb::DataChunk> chunk;
-  duckdb::ErrorData error;
-  if (result->data->TryFetch(chunk, error) && chunk) {
-    duckdb::idx_t rows_count = chunk->size();
-    duckdb::idx_t columns_count = chunk->ColumnCount();
-
-    for (duckdb::idx_t row = 0; row < rows_count; row++) {
-      std::vector<ERL_NIF_TERM> columns(columns_count);
-      for (duckdb::idx_t col = 0; col < columns_count; col++) {
-        auto value = chunk->GetValue(col, row);
-        ERL_NIF_TERM sink;
-        if (!nif::value_to_term(env, value, sink))
-          return nif::make_error_tuple(env, "Can't convert DuckDB value of type '" + value.type().ToString() + "' to the Erlang term.");
-        columns[col] = sink;
-      }
+static ERL_NIF_TERM
+async_appender_close(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
+    return enif_make_badarg(env);
 
-      rows.push_back(enif_make_list_from_array(env, &columns[0], columns_count));
-    }
+  auto apres = get_resource<nif::AsyncAppender>(env, argv[0], async_appender_nif_type);
+  if (!apres)
+    return enif_make_badarg(env);
 
-    return enif_make_list_from_array(env, &rows[0], rows.size());
-  } else {
-    return enif_make_list(env, 0);
-  }
+  std::string error;
+  if (!apres->data->close(error))
+    return nif::make_error_tuple(env, error);
+
+  return nif::atoms.ok;
 }
 
 static ERL_NIF_TERM
-fetch_all(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+release(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
   if (argc != 1)
     return enif_make_badarg(env);
 
-  auto result = get_resource<duckdb::QueryResult>(env, argv[0]);
-  if (!result)
+  if (auto res = get_resource<duckdb::Appender>(env, argv[0]))
+    res->data = nullptr;
+
+  if (auto res = get_resource<duckdb::PreparedStatement>(env, argv[0]))
+    res->data = nullptr;
+
+  if (auto res = get_resource<duckdb::QueryResult>(env, argv[0])) {
+    std::lock_guard<std::mutex> lock(res->mutex);
+    res->data = nullptr;
+  }
+
+  if (auto res = get_resource<duckdb::Connection>(env, argv[0]))
+    res->data = nullptr;
+
+  if (auto res = get_resource<nif::ConnectionPool>(env, argv[0]))
+    res->data = nullptr;
+
+  if (auto res = get_resource<duckdb::DuckDB>(env, argv[0]))
+    res->data = nullptr;
+
+  if (auto res = get_resource<duckdb::DBConfig>(env, argv[0]))
+    res->data = nullptr;
+
+  return nif::atoms.ok;
+}
+
+//
+// Interrupts the query running on the connection (or on the connection of the prepared statement).
+// Runs on the normal scheduler, so it is not queued behind the dirty NIFs.
+//
+static ERL_NIF_TERM
+cancel(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1)
     return enif_make_badarg(env);
 
-  if (result->data->HasError()) {
-    auto error = result->data->GetError();
-    return nif::make_error_tuple(env, error);
+  if (auto connres = get_resource<duckdb::Connection>(env, argv[0])) {
+    connres->data->Interrupt();
+    return nif::atoms.ok;
   }
 
-  std::vector<ERL_NIF_TERM> rows;
+  if (auto stmtres = get_resource<duckdb::PreparedStatement>(env, argv[0])) {
+    stmtres->data->context->Interrupt();
+    return nif::atoms.ok;
+  }
 
-  duckdb::unique_ptr<duckdb::DataChunk> chunk;
-  duckdb::ErrorData error;
-  while (result->data->TryFetch(chunk, error) && chunk) {
-    duckdb::idx_t rows_count = chunk->size();
-    duckdb::idx_t columns_count = chunk->ColumnCount();
-    for (duckdb::idx_t row = 0; row < rows_count; row++) {
-      std::vector<ERL_NIF_TERM> columns(columns_count);
-      for (duckdb::idx_t col = 0; col < columns_count; col++) {
-        auto value = chunk->GetValue(col, row);
-        ERL_NIF_TERM sink;
-        if (!nif::value_to_term(env, value, sink))
-          return nif::make_error_tuple(env, "Can't convert DuckDB value of type '" + value.type().ToString() + "' to the Erlang term.");
-        columns[col] = sink;
-      }
+  return enif_make_badarg(env);
+}
 
-      rows.push_back(enif_make_list_from_array(env, &columns[0], columns_count));
-    }
+/*
+ * Cooperative query
+ *
+ * The query is run task by task (PendingQueryResult::ExecuteTask) on the normal scheduler
+ * yielding with enif_schedule_nif as soon as the timeslice is consumed. If a single task
+ * takes the whole timeslice, or the query keeps waiting for the tasks of the DuckDB threads,
+ * the rest of the query is run on the dirty scheduler.
+ * The statement is parsed, bound and planned on the dirty scheduler, that takes the context
+ * lock and would block the normal scheduler while another query is running on the connection.
+ * Every step takes the turn of the connection queries, the step on the normal scheduler
+ * does not wait for it, the query goes to the dirty scheduler if another query is running.
+ */
+
+static const long long TIMESLICE_MICROS = 1000;
+// The steps in a row finding no task to run before the query goes to the dirty scheduler to wait
+static const int MAX_BLOCKED_STEPS = 16;
+
+// The turn is held by the caller
+static ERL_NIF_TERM
+finish_pending_query(ErlNifEnv* env, erlang_resource<duckdb::PendingQueryResult>* pending) {
+  if (pending->data->HasError()) {
+    auto error = make_query_error(env, pending->data->GetErrorObject(), false);
+    pending->data.reset();
+    return error;
   }
 
-  if (rows.size())
-    return enif_make_list_from_array(env, &rows[0], rows.size());
-  else
-    return enif_make_list(env, 0);
+  duckdb::unique_ptr<duckdb::QueryResult> result = pending->data->Execute();
+  pending->data.reset();
+
+  return make_query_result(env, std::move(result));
 }
 
 static ERL_NIF_TERM
-appender(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc < 2 || argc > 3) {
+step_pending_query(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  auto pending = get_resource<duckdb::PendingQueryResult>(env, argv[0]);
+  if (!pending)
     return enif_make_badarg(env);
-  }
 
-  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
-  if (!connres)
+  int blocked_steps = 0;
+  if (argc > 1 && !enif_get_int(env, argv[1], &blocked_steps))
     return enif_make_badarg(env);
 
-  ErlNifBinary binary_table_name;
-  if (argc == 2) {
-    // Only table name is provided
-    if (!enif_inspect_binary(env, argv[1], &binary_table_name)) {
-      return enif_make_badarg(env);
-    }
+  if (enif_thread_type() == ERL_NIF_THR_NORMAL_SCHEDULER) {
+    nif::QueryOwner::Turn turn(*pending->owner, std::try_to_lock);
+    if (!turn.owns())
+      return enif_schedule_nif(env, "step_pending_query", ERL_NIF_DIRTY_JOB_IO_BOUND, step_pending_query, 1, argv);
 
-    std::string table_name((const char*)binary_table_name.data, binary_table_name.size);
+    for (;;) {
+      auto started = std::chrono::steady_clock::now();
+      auto state = pending->data->ExecuteTask();
+      long long spent = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
 
-    if (!connres->data->TableInfo(table_name))
-      return nif::make_error_tuple(env, "Table '" + table_name + "' could not be found");
+      if (state == duckdb::PendingExecutionResult::EXECUTION_ERROR || duckdb::PendingQueryResult::IsResultReady(state))
+        break;
 
-    ErlangResourceBuilder<duckdb::Appender> resource_builder(appender_nif_type, *connres->data, table_name);
-    return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
-  } else {
-    ErlNifBinary binary_schema_name;
+      if (spent >= TIMESLICE_MICROS)
+        return enif_schedule_nif(env, "step_pending_query", ERL_NIF_DIRTY_JOB_IO_BOUND, step_pending_query, 1, argv);
 
-    // Schema name and table name are provided
-    if (!enif_inspect_binary(env, argv[1], &binary_schema_name)) {
-      return enif_make_badarg(env);
-    }
-    if (!enif_inspect_binary(env, argv[2], &binary_table_name)) {
-      return enif_make_badarg(env);
-    }
+      // the tasks are run by the DuckDB threads, give the scheduler to others meanwhile,
+      // but do not spin on it for the whole query
+      bool blocked = state == duckdb::PendingExecutionResult::BLOCKED || state == duckdb::PendingExecutionResult::NO_TASKS_AVAILABLE;
+      if (blocked) {
+        if (++blocked_steps >= MAX_BLOCKED_STEPS)
+          return enif_schedule_nif(env, "step_pending_query", ERL_NIF_DIRTY_JOB_IO_BOUND, step_pending_query, 1, argv);
 
-    std::string schema_name((const char*)binary_schema_name.data, binary_schema_name.size);
-    std::string table_name((const char*)binary_table_name.data, binary_table_name.size);
+        ERL_NIF_TERM step_argv[] = {argv[0], enif_make_int(env, blocked_steps)};
+        return enif_schedule_nif(env, "step_pending_query", 0, step_pending_query, 2, step_argv);
+      }
 
-    if (!connres->data->TableInfo(schema_name, table_name)) {
-      return nif::make_error_tuple(env, "Table '" + schema_name + "." + table_name + "' could not be found");
+      blocked_steps = 0;
+
+      int percent = std::max(1, (int)(spent * 100 / TIMESLICE_MICROS));
+      if (enif_consume_timeslice(env, percent))
+        return enif_schedule_nif(env, "step_pending_query", 0, step_pending_query, 1, argv);
     }
 
-    ErlangResourceBuilder<duckdb::Appender> resource_builder(appender_nif_type, *connres->data, schema_name, table_name);
-    return nif::make_ok_tuple(env, resource_builder.make_and_release_resource(env));
+    return finish_pending_query(env, pending);
   }
+
+  // on the dirty scheduler runs the rest of the query at once, waiting for the running query
+  // and the blocked tasks
+  nif::QueryOwner::Turn turn(*pending->owner);
+  return finish_pending_query(env, pending);
 }
 
 static ERL_NIF_TERM
-appender_add_row(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2)
-    return enif_make_badarg(env);
+start_pending_query(ErlNifEnv* env, duckdb::unique_ptr<duckdb::PendingQueryResult> pending, const std::shared_ptr<nif::QueryOwner>& owner) {
+  if (pending->HasError())
+    return make_query_error(env, pending->GetErrorObject(), false);
 
-  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
-  if (!apres)
-    return enif_make_badarg(env);
+  ErlangResourceBuilder<duckdb::PendingQueryResult> resource_builder(
+    pending_query_nif_type,
+    std::move(pending));
 
-  if (!enif_is_list(env, argv[1]))
+  resource_builder.get()->owner = owner;
+
+  ERL_NIF_TERM pending_term = resource_builder.make_and_release_resource(env);
+
+  return enif_schedule_nif(env, "step_pending_query", 0, step_pending_query, 1, &pending_term);
+}
+
+// the deadline, the owner and the profiler can't be kept across the steps, timeout, release_on_exit and profile are not supported
+static bool
+get_cooperative_options(ErlNifEnv* env, ERL_NIF_TERM term, nif::QueryOptions& options) {
+  return nif::term_to_query_options(env, term, options) && !options.timeout && !options.release_on_exit && !options.profile;
+}
+
+static ERL_NIF_TERM
+prepare_query_cooperative(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  auto connres = get_resource<duckdb::Connection>(env, argv[0]);
+
+  ErlNifBinary sql_stmt;
+  nif::QueryOptions options;
+  if (!connres || !enif_inspect_binary(env, argv[1], &sql_stmt) || !get_cooperative_options(env, argv[3], options))
     return enif_make_badarg(env);
 
-  const duckdb::vector<duckdb::LogicalType>& types = apres->data->GetActiveTypes();
+  std::string sql((const char*)sql_stmt.data, sql_stmt.size);
 
-  unsigned row_size = 0;
-  if(!enif_get_list_length(env, argv[1], &row_size) || row_size != types.size())
+  nif::QueryOwner::Turn turn(*connres->owner);
+
+  if (enif_is_empty_list(env, argv[2]))
+    return start_pending_query(env, connres->data->PendingQuery(sql, options.stream), connres->owner);
+
+  auto statement = connres->data->Prepare(sql);
+  if (!statement->success)
+    return nif::make_error_tuple(env, statement->error.Message());
+
+  duckdb::vector<duckdb::Value> query_params;
+
+  ERL_NIF_TERM error;
+  if (!nif::ParamsBinder(*statement).bind(env, argv[2], query_params, error))
+    return error;
+
+  return start_pending_query(env, statement->PendingQuery(query_params, options.stream), connres->owner);
+}
+
+static ERL_NIF_TERM
+query_cooperative(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 4)
+    return enif_make_badarg(env);
+
+  ErlNifBinary sql_stmt;
+  nif::QueryOptions options;
+  if (!get_resource<duckdb::Connection>(env, argv[0]) || !enif_inspect_binary(env, argv[1], &sql_stmt) ||
+      !get_cooperative_options(env, argv[3], options))
     return enif_make_badarg(env);
 
-  apres->data->BeginRow();
+  return enif_schedule_nif(env, "prepare_query_cooperative", ERL_NIF_DIRTY_JOB_IO_BOUND, prepare_query_cooperative, argc, argv);
+}
+
+static ERL_NIF_TERM
+prepare_statement_cooperative(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  auto stmtres = get_resource<duckdb::PreparedStatement>(env, argv[0]);
 
-  ERL_NIF_TERM item, items;
-  items = argv[1];
-  int column_idx = 0;
-  while(enif_get_list_cell(env, items, &item, &items)) {
-    duckdb::Value value;
-    if (!nif::term_to_value(env, item, types[column_idx], value))
-      return nif::make_error_tuple(env, "invalid type of column: " + std::to_string(column_idx));
+  nif::QueryOptions options;
+  if (!stmtres || !get_cooperative_options(env, argv[2], options))
+    return enif_make_badarg(env);
 
-    apres->data->Append(value);
-    column_idx++;
-  }
+  duckdb::vector<duckdb::Value> query_params;
 
-  apres->data->EndRow();
+  ERL_NIF_TERM error;
+  if (!stmtres->binder.bind(env, argv[1], query_params, error))
+    return error;
 
-  return nif::make_atom(env, "ok");
+  nif::QueryOwner::Turn turn(*stmtres->owner);
+  return start_pending_query(env, stmtres->data->PendingQuery(query_params, options.stream), stmtres->owner);
 }
 
 static ERL_NIF_TERM
-appender_add_rows(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 2)
+execute_statement_cooperative(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 3)
     return enif_make_badarg(env);
 
-  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
-  if (!apres)
+  nif::QueryOptions options;
+  if (!get_resource<duckdb::PreparedStatement>(env, argv[0]) || !get_cooperative_options(env, argv[2], options))
     return enif_make_badarg(env);
 
-  if (!enif_is_list(env, argv[1]))
+  return enif_schedule_nif(env, "prepare_statement_cooperative", ERL_NIF_DIRTY_JOB_IO_BOUND, prepare_statement_cooperative, argc, argv);
+}
+
+/*
+ * Async API
+ *
+ * The NIF arguments are copied into the job env and the synchronous NIF function is run
+ * on the worker pool with them. The copied terms keep the resources alive until the job
+ * is done. The caller gets {:duckdbex, ref, result} message, where result is what the
+ * synchronous NIF returns. The arguments are validated before the job is submitted,
+ * the badarg the job still hits (the parameter list the binder rejects, the resource
+ * released before the job runs) is sent as {:error, :badarg}, the exception can't be sent.
+ */
+
+typedef ERL_NIF_TERM (*nif_function)(ErlNifEnv*, int, const ERL_NIF_TERM[]);
+
+static bool
+is_proper_list(ErlNifEnv* env, ERL_NIF_TERM term) {
+  unsigned length;
+  return enif_get_list_length(env, term, &length);
+}
+
+static ERL_NIF_TERM
+run_async(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[], nif_function function) {
+  ErlNifPid caller;
+  if (!enif_self(env, &caller))
     return enif_make_badarg(env);
 
-  const duckdb::vector<duckdb::LogicalType>& types = apres->data->GetActiveTypes();
+  ErlNifEnv* job_env = enif_alloc_env();
+  if (!job_env)
+    return nif::make_error_tuple(env, "can't allocate the job env");
 
-  ERL_NIF_TERM item, row, rows;
-  rows = argv[1];
-  while(enif_get_list_cell(env, rows, &row, &rows)) {
-    if (!enif_is_list(env, row))
-      return enif_make_badarg(env);
+  std::vector<ERL_NIF_TERM> job_argv(argc);
+  for (int i = 0; i < argc; i++)
+    job_argv[i] = enif_make_copy(job_env, argv[i]);
 
-    unsigned row_size = 0;
-    if(!enif_get_list_length(env, row, &row_size) || row_size != types.size())
-      return enif_make_badarg(env);
+  ERL_NIF_TERM ref = enif_make_ref(env);
+  ERL_NIF_TERM job_ref = enif_make_copy(job_env, ref);
 
-    apres->data->BeginRow();
-    int column_idx = 0;
-    while(enif_get_list_cell(env, row, &item, &row)) {
-      duckdb::Value value;
-      if (!nif::term_to_value(env, item, types[column_idx], value))
-        return nif::make_error_tuple(env, "invalid type of column: " + std::to_string(column_idx));
+  int64_t queued_at = nif::Telemetry::enabled() ? nif::CallSpan::now() : 0;
 
-      apres->data->Append(value);
-      column_idx++;
+  bool submitted = worker_pool.submit([=]() {
+    ErlNifPid to = caller;
+    async_caller = &to;
+    async_queued_at = queued_at;
+
+    ERL_NIF_TERM result;
+    try {
+      result = function(job_env, (int)job_argv.size(), job_argv.data());
+    } catch (std::exception& ex) {
+      result = nif::make_error_tuple(job_env, ex.what());
     }
-    apres->data->EndRow();
+
+    ERL_NIF_TERM reason;
+    if (enif_has_pending_exception(job_env, &reason))
+      result = nif::make_error_tuple(job_env, nif::atoms.badarg);
+
+    async_caller = nullptr;
+    async_queued_at = 0;
+
+    ERL_NIF_TERM message = enif_make_tuple3(job_env, nif::atoms.duckdbex, job_ref, result);
+
+    enif_send(NULL, &to, job_env, message);
+    enif_free_env(job_env);
+  });
+
+  if (!submitted) {
+    enif_free_env(job_env);
+    return nif::make_error_tuple(env, "async workers are not running");
   }
 
-  return nif::make_atom(env, "ok");
+  return nif::make_ok_tuple(env, ref);
 }
 
 static ERL_NIF_TERM
-appender_flush(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1)
+query_async(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 4)
     return enif_make_badarg(env);
 
-  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
-  if (!apres)
+  if (!get_resource<duckdb::Connection>(env, argv[0]))
     return enif_make_badarg(env);
 
-  apres->data->Flush();
+  nif::QueryOptions options;
+  if (!enif_is_binary(env, argv[1]) || !is_proper_list(env, argv[2]) || !nif::term_to_query_options(env, argv[3], options))
+    return enif_make_badarg(env);
 
-  return nif::make_atom(env, "ok");
+  return run_async(env, argc, argv, query_with_parameters);
 }
 
 static ERL_NIF_TERM
-appender_close(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1)
+execute_statement_async(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 3)
     return enif_make_badarg(env);
 
-  auto apres = get_resource<duckdb::Appender>(env, argv[0]);
-  if (!apres)
+  if (!get_resource<duckdb::PreparedStatement>(env, argv[0]))
     return enif_make_badarg(env);
 
-  apres->data->Close();
-  apres->data = nullptr;
+  nif::QueryOptions options;
+  if (!is_proper_list(env, argv[1]) || !nif::term_to_query_options(env, argv[2], options))
+    return enif_make_badarg(env);
 
-  return nif::make_atom(env, "ok");
+  return run_async(env, argc, argv, execute_statement);
 }
 
 static ERL_NIF_TERM
-release(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
-  if (argc != 1)
+pool_query_async(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 4)
     return enif_make_badarg(env);
 
-  if (auto res = get_resource<duckdb::Appender>(env, argv[0]))
-    res->data = nullptr;
+  if (!get_resource<nif::ConnectionPool>(env, argv[0]))
+    return enif_make_badarg(env);
 
-  if (auto res = get_resource<duckdb::PreparedStatement>(env, argv[0]))
-    res->data = nullptr;
+  nif::QueryOptions options;
+  if (!enif_is_binary(env, argv[1]) || !is_proper_list(env, argv[2]) || !nif::term_to_query_options(env, argv[3], options) || options.stream)
+    return enif_make_badarg(env);
 
-  if (auto res = get_resource<duckdb::QueryResult>(env, argv[0]))
-    res->data = nullptr;
+  return run_async(env, argc, argv, pool_query);
+}
 
-  if (auto res = get_resource<duckdb::Connection>(env, argv[0]))
-    res->data = nullptr;
+static ERL_NIF_TERM
+fetch_chunk_async(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1 || !get_resource<duckdb::QueryResult>(env, argv[0]))
+    return enif_make_badarg(env);
 
-  if (auto res = get_resource<duckdb::DuckDB>(env, argv[0]))
-    res->data = nullptr;
+  return run_async(env, argc, argv, fetch_chunk);
+}
 
-  if (auto res = get_resource<duckdb::DBConfig>(env, argv[0]))
-    res->data = nullptr;
+static ERL_NIF_TERM
+fetch_all_async(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
+  if (argc != 1 || !get_resource<duckdb::QueryResult>(env, argv[0]))
+    return enif_make_badarg(env);
+
+  return run_async(env, argc, argv, fetch_all);
+}
+
+static unsigned
+async_workers_count(ErlNifEnv* env, ERL_NIF_TERM info) {
+  unsigned count = 0;
+  if (enif_get_uint(env, info, &count) && count)
+    return count;
+
+  count = std::thread::hardware_concurrency();
+  return count ? count : 4;
+}
+
+/*
+ * Down callbacks of the monitored owners
+ */
+
+// Only the query of the exited process is interrupted, not the one it was waiting for
+static void
+connection_down(ErlNifEnv* env, void* obj, ErlNifPid* pid, ErlNifMonitor* monitor) {
+  auto* resource = static_cast<erlang_resource<duckdb::Connection>*>(obj);
+  if (resource->data && resource->owner->is_owner(*pid))
+    resource->data->Interrupt();
+}
+
+static void
+prepared_statement_down(ErlNifEnv* env, void* obj, ErlNifPid* pid, ErlNifMonitor* monitor) {
+  auto* resource = static_cast<erlang_resource<duckdb::PreparedStatement>*>(obj);
+  if (resource->data && resource->owner->is_owner(*pid))
+    resource->data->context->Interrupt();
+}
+
+// The result being fetched by another process at the moment is left for GC
+static void
+query_result_down(ErlNifEnv* env, void* obj, ErlNifPid* pid, ErlNifMonitor* monitor) {
+  auto* resource = static_cast<erlang_resource<duckdb::QueryResult>*>(obj);
+  std::unique_lock<std::mutex> lock(resource->mutex, std::try_to_lock);
+  if (lock.owns_lock())
+    resource->data.reset();
+}
 
-  return nif::make_atom(env, "ok");
+static void
+async_appender_down(ErlNifEnv* env, void* obj, ErlNifPid* pid, ErlNifMonitor* monitor) {
+  auto* resource = static_cast<erlang_resource<nif::AsyncAppender>*>(obj);
+  resource->data->detach();
 }
 
 /*
@@ -713,6 +2063,9 @@ release(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[]) {
  */
 static int
 on_load(ErlNifEnv* env, void** priv, ERL_NIF_TERM info) {
+  nif::make_atoms(env);
+  *priv = &nif::atoms;
+
   database_nif_type = enif_open_resource_type(
     env,
     "duckdbex",
@@ -737,11 +2090,11 @@ on_load(ErlNifEnv* env, void** priv, ERL_NIF_TERM info) {
       return -1;
   }
 
-  connection_nif_type = enif_open_resource_type(
+  ErlNifResourceTypeInit connection_init = {resource_destructor<duckdb::Connection>, NULL, connection_down};
+  connection_nif_type = enif_open_resource_type_x(
     env,
-    "duckdbex",
     "connection_nif_type",
-    resource_destructor<duckdb::Connection>,
+    &connection_init,
     ERL_NIF_RT_CREATE,
     NULL);
 
@@ -761,11 +2114,11 @@ on_load(ErlNifEnv* env, void** priv, ERL_NIF_TERM info) {
       return -1;
   }
 
-  query_result_nif_type = enif_open_resource_type(
+  ErlNifResourceTypeInit query_result_init = {resource_destructor<duckdb::QueryResult>, NULL, query_result_down};
+  query_result_nif_type = enif_open_resource_type_x(
     env,
-    "duckdbex",
     "query_result_nif_type",
-    resource_destructor<duckdb::QueryResult>,
+    &query_result_init,
     ERL_NIF_RT_CREATE,
     NULL);
 
@@ -773,11 +2126,11 @@ on_load(ErlNifEnv* env, void** priv, ERL_NIF_TERM info) {
       return -1;
   }
 
-  prepared_statement_nif_type = enif_open_resource_type(
+  ErlNifResourceTypeInit prepared_statement_init = {resource_destructor<duckdb::PreparedStatement>, NULL, prepared_statement_down};
+  prepared_statement_nif_type = enif_open_resource_type_x(
     env,
-    "duckdbex",
     "prepared_statement_nif_type",
-    resource_destructor<duckdb::PreparedStatement>,
+    &prepared_statement_init,
     ERL_NIF_RT_CREATE,
     NULL);
 
@@ -785,6 +2138,44 @@ on_load(ErlNifEnv* env, void** priv, ERL_NIF_TERM info) {
       return -1;
   }
 
+  pending_query_nif_type = enif_open_resource_type(
+    env,
+    "duckdbex",
+    "pending_query_nif_type",
+    resource_destructor<duckdb::PendingQueryResult>,
+    ERL_NIF_RT_CREATE,
+    NULL);
+
+  if (!pending_query_nif_type) {
+      return -1;
+  }
+
+  connection_pool_nif_type = enif_open_resource_type(
+    env,
+    "duckdbex",
+    "connection_pool_nif_type",
+    resource_destructor<nif::ConnectionPool>,
+    ERL_NIF_RT_CREATE,
+    NULL);
+
+  if (!connection_pool_nif_type) {
+      return -1;
+  }
+
+  ErlNifResourceTypeInit async_appender_init = {resource_destructor<nif::AsyncAppender>, NULL, async_appender_down};
+  async_appender_nif_type = enif_open_resource_type_x(
+    env,
+    "async_appender_nif_type",
+    &async_appender_init,
+    ERL_NIF_RT_CREATE,
+    NULL);
+
+  if (!async_appender_nif_type) {
+      return -1;
+  }
+
+  worker_pool.start(async_workers_count(env, info));
+
   return 0;
 }
 
@@ -795,9 +2186,19 @@ on_reload(ErlNifEnv* env, void** priv_data, ERL_NIF_TERM load_info) {
 
 static int
 on_upgrade(ErlNifEnv* env, void** priv, void** old_priv_data, ERL_NIF_TERM load_info) {
+  nif::make_atoms(env);
+  *priv = &nif::atoms;
+
+  worker_pool.start(async_workers_count(env, load_info));
   return 0;
 }
 
+static void
+on_unload(ErlNifEnv* env, void* priv) {
+  worker_pool.stop();
+  deadline_timer.stop();
+}
+
 static ErlNifFunc nif_funcs[] = {
   {"source_id", 0, source_id, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"library_version", 0, library_version, ERL_NIF_DIRTY_JOB_IO_BOUND},
@@ -807,31 +2208,61 @@ static ErlNifFunc nif_funcs[] = {
   {"number_of_threads", 1, number_of_threads, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"extension_is_loaded", 2, extension_is_loaded, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"create_config", 0, create_config, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"create_config", 1, create_config, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"set_config_option", 3, set_config_option, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"get_config_options", 0, get_config_options, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"open", 2, open, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"allocator_stats", 1, allocator_stats},
+  {"set_telemetry_collector", 1, set_telemetry_collector},
   {"connection", 1, connection, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"connection", 2, connection, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"statement_cache_stats", 1, statement_cache_stats, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"clear_statement_cache", 1, clear_statement_cache, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"connection_pool", 2, connection_pool, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"pool_query", 4, pool_query, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"query", 2, query_without_parameters, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"query", 3, query_with_parameters, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"query", 4, query_with_parameters, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"prepare_statement", 2, prepare_statement, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"execute_statement", 1, execute_statement, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"execute_statement", 2, execute_statement, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"execute_statement", 3, execute_statement, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"execute_statement_many", 3, execute_statement_many, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"begin_transaction", 1, begin_transaction, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"commit", 1, commit, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"rollback", 1, rollback, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"set_auto_commit", 2, set_auto_commit, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"is_auto_commit", 1, is_auto_commit, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"has_active_transaction", 1, has_active_transaction, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"enable_profiling", 1, enable_profiling, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"disable_profiling", 1, disable_profiling, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"profiling_tree", 1, profiling_tree, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"columns", 1, columns, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"fetch_chunk", 1, fetch_chunk, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"fetch_all", 1, fetch_all, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"fetch_chunk_columns", 1, fetch_chunk_columns, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"fetch_all_columns", 1, fetch_all_columns, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"fetch_chunk_packed", 1, fetch_chunk_packed, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"cancel", 1, cancel, 0},
+  {"query_cooperative", 4, query_cooperative, 0},
+  {"execute_statement_cooperative", 3, execute_statement_cooperative, 0},
+  {"query_async", 4, query_async, 0},
+  {"execute_statement_async", 3, execute_statement_async, 0},
+  {"pool_query_async", 4, pool_query_async, 0},
+  {"fetch_chunk_async", 1, fetch_chunk_async, 0},
+  {"fetch_all_async", 1, fetch_all_async, 0},
   {"appender", 2, appender, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"appender", 3, appender, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"appender_add_row", 2, appender_add_row, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"appender_add_rows", 2, appender_add_rows, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"appender_add_columns", 2, appender_add_columns, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"async_appender", 4, async_appender, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"async_appender_add_rows", 2, async_appender_add_rows, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"async_appender_flush", 1, async_appender_flush, ERL_NIF_DIRTY_JOB_IO_BOUND},
+  {"async_appender_close", 1, async_appender_close, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"appender_flush", 1, appender_flush, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"appender_close", 1, appender_close, ERL_NIF_DIRTY_JOB_IO_BOUND},
   {"release", 1, release, ERL_NIF_DIRTY_JOB_IO_BOUND}
 };
 
-ERL_NIF_INIT(Elixir.Duckdbex.NIF, nif_funcs, on_load, on_reload, on_upgrade, NULL)
+ERL_NIF_INIT(Elixir.Duckdbex.NIF, nif_funcs, on_load, on_reload, on_upgrade, on_unload)
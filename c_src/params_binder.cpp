@@ -0,0 +1,72 @@
+#include "params_binder.h"
+#include "term.h"
+#include <string>
+
+nif::ParamsBinder::ParamsBinder(duckdb::PreparedStatement& statement) {
+  duckdb::case_insensitive_map_t<duckdb::LogicalType> params_types = statement.GetExpectedParameterTypes();
+
+  params.resize(params_types.size());
+  for (size_t idx = 0; idx < params.size(); idx++) {
+    auto it = params_types.find(std::to_string(idx + 1));
+    if (it == params_types.end())
+      continue;
+
+    params[idx].type = it->second;
+    params[idx].convert = get_term_converter(it->second);
+  }
+}
+
+nif::ParamsBinder::Status
+nif::ParamsBinder::bind_params(ErlNifEnv* env, ERL_NIF_TERM args, duckdb::vector<duckdb::Value>& values, ERL_NIF_TERM& reason) const {
+  // the statement without parameters ignores the arguments
+  if (params.empty())
+    return Status::OK;
+
+  unsigned length = 0;
+  if (!enif_get_list_length(env, args, &length))
+    return Status::BADARG;
+
+  values.reserve(length);
+
+  static const duckdb::LogicalType invalid_type;
+
+  ERL_NIF_TERM item, items = args;
+  size_t idx = 0;
+  while (enif_get_list_cell(env, items, &item, &items)) {
+    duckdb::Value value;
+
+    bool converted;
+    if (idx >= params.size())
+      converted = term_to_value(env, item, invalid_type, value);
+    else if (term_to_null(env, item, value))
+      converted = true;
+    else if (params[idx].convert)
+      converted = params[idx].convert(env, item, value);
+    else
+      converted = term_to_value(env, item, params[idx].type, value);
+
+    if (!converted) {
+      reason = make_binary_term(env, "invalid type of parameter #" + std::to_string(idx + 1));
+      return Status::INVALID_PARAM;
+    }
+
+    values.push_back(std::move(value));
+    idx++;
+  }
+
+  return Status::OK;
+}
+
+bool nif::ParamsBinder::bind(ErlNifEnv* env, ERL_NIF_TERM args, duckdb::vector<duckdb::Value>& values, ERL_NIF_TERM& error) const {
+  ERL_NIF_TERM reason;
+  switch (bind_params(env, args, values, reason)) {
+    case Status::OK:
+      return true;
+    case Status::BADARG:
+      error = enif_make_badarg(env);
+      return false;
+    default:
+      error = make_error_tuple(env, reason);
+      return false;
+  }
+}
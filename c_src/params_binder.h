@@ -0,0 +1,39 @@
+#pragma once
+#include "duckdb.hpp"
+#include "term_to_value.h"
+#include <erl_nif.h>
+#include <vector>
+
+namespace nif {
+  /*
+   * The parameters of the prepared statement resolved once at prepare: the type and
+   * the converter of every parameter by its position, so binding the arguments is
+   * a straight loop of the conversions.
+   */
+  class ParamsBinder {
+    public:
+      ParamsBinder(duckdb::PreparedStatement& statement);
+
+      ParamsBinder(const ParamsBinder&) = delete;
+      ParamsBinder& operator=(const ParamsBinder&) = delete;
+
+      enum class Status { OK, BADARG, INVALID_PARAM };
+
+      // The arguments which are not a proper list are the BADARG, on INVALID_PARAM the reason
+      // of the error is put into the 'reason'
+      Status bind_params(ErlNifEnv* env, ERL_NIF_TERM args, duckdb::vector<duckdb::Value>& params, ERL_NIF_TERM& reason) const;
+
+      // On failure the error term to return is put into the 'error': the badarg or {:error, reason}
+      bool bind(ErlNifEnv* env, ERL_NIF_TERM args, duckdb::vector<duckdb::Value>& params, ERL_NIF_TERM& error) const;
+
+      size_t size() const { return params.size(); }
+
+    private:
+      struct Param {
+        duckdb::LogicalType type;
+        term_converter convert;
+      };
+
+      std::vector<Param> params;
+  };
+}
@@ -0,0 +1,122 @@
+#include "profiling.h"
+#include "atoms.h"
+#include "term.h"
+#include "value_to_term.h"
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace {
+  std::string metric_name(duckdb::MetricsType metric) {
+    std::string name = duckdb::EnumUtil::ToString(metric);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+    return name;
+  }
+
+  ERL_NIF_TERM metric_to_term(ErlNifEnv* env, duckdb::MetricsType metric, const duckdb::Value& value) {
+    // the profiler keeps the operator type as its PhysicalOperatorType code
+    if (metric == duckdb::MetricsType::OPERATOR_TYPE && value.type().id() == duckdb::LogicalTypeId::UTINYINT) {
+      auto type = static_cast<duckdb::PhysicalOperatorType>(value.GetValue<uint8_t>());
+      return nif::make_binary_term(env, duckdb::EnumUtil::ToString(type));
+    }
+
+    ERL_NIF_TERM term;
+    if (!nif::value_to_term(env, value, term))
+      return nif::make_binary_term(env, value.ToString());
+
+    return term;
+  }
+}
+
+ERL_NIF_TERM nif::profiling_node_to_term(ErlNifEnv* env, duckdb::ProfilingNode& node) {
+  auto& info = node.GetProfilingInfo();
+
+  ERL_NIF_TERM map = enif_make_new_map(env);
+  for (auto& metric : info.metrics) {
+    if (metric.first == duckdb::MetricsType::EXTRA_INFO)
+      continue;
+
+    enif_make_map_put(env, map, make_atom(env, metric_name(metric.first)), metric_to_term(env, metric.first, metric.second), &map);
+  }
+
+  ERL_NIF_TERM extra_info = enif_make_new_map(env);
+  for (auto& item : info.extra_info)
+    enif_make_map_put(env, extra_info, make_binary_term(env, item.first), make_binary_term(env, item.second), &extra_info);
+
+  enif_make_map_put(env, map, atoms.extra_info, extra_info, &map);
+
+  std::vector<ERL_NIF_TERM> children;
+  children.reserve(node.GetChildCount());
+  for (duckdb::idx_t idx = 0; idx < node.GetChildCount(); idx++) {
+    if (auto child = node.GetChild(idx))
+      children.push_back(profiling_node_to_term(env, *child));
+  }
+
+  enif_make_map_put(env, map, atoms.children, enif_make_list_from_array(env, children.data(), children.size()), &map);
+
+  return map;
+}
+
+nif::ProfilingTree::~ProfilingTree() {
+  if (env)
+    enif_free_env(env);
+}
+
+void nif::ProfilingTree::capture(duckdb::ClientContext& context) {
+  auto node = context.GetProfilingTree();
+  if (!node)
+    return;
+
+  if (!env && !(env = enif_alloc_env()))
+    return;
+
+  tree = profiling_node_to_term(env, *node);
+}
+
+ERL_NIF_TERM nif::ProfilingTree::get(ErlNifEnv* caller) const {
+  if (!env || !tree)
+    return atoms.nil;
+
+  return enif_make_copy(caller, tree);
+}
+
+void nif::Profiling::enable(duckdb::ClientContext& context) {
+  std::lock_guard<std::mutex> guard(mutex);
+  if (count++)
+    return;
+
+  auto lock = context.LockContext();
+  auto& config = duckdb::ClientConfig::GetConfig(context);
+  owned = !config.enable_profiler;
+  if (owned) {
+    config.enable_profiler = true;
+    config.emit_profiler_output = false;
+  }
+}
+
+void nif::Profiling::disable(duckdb::ClientContext& context) {
+  std::lock_guard<std::mutex> guard(mutex);
+  // nothing enabled it, disables the profiler enabled by the sql
+  if (!count) {
+    auto lock = context.LockContext();
+    duckdb::ClientConfig::GetConfig(context).enable_profiler = false;
+    return;
+  }
+
+  if (--count || !owned)
+    return;
+
+  auto lock = context.LockContext();
+  duckdb::ClientConfig::GetConfig(context).enable_profiler = false;
+}
+
+nif::QueryProfiling::QueryProfiling(Profiling& profiling, duckdb::ClientContext& context, bool enable)
+  : profiling(profiling), context(context), enabled(enable) {
+  if (enabled)
+    profiling.enable(context);
+}
+
+nif::QueryProfiling::~QueryProfiling() {
+  if (enabled)
+    profiling.disable(context);
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "duckdb.hpp"
+#include <erl_nif.h>
+#include <mutex>
+
+namespace nif {
+  /*
+   * Converts the profiling tree of the last query into the nested map: the metrics
+   * of the node by their lowercased names (operator_type, operator_timing,
+   * operator_cardinality, ... as the profiling settings of the connection select them),
+   * `extra_info` map of the operator details and `children` list of the child nodes.
+   */
+  ERL_NIF_TERM profiling_node_to_term(ErlNifEnv* env, duckdb::ProfilingNode& node);
+
+  /*
+   * The profiling tree of the query taken while the query holds its turn on the connection,
+   * kept in its own env by the query result
+   */
+  class ProfilingTree {
+    public:
+      ProfilingTree() : env(nullptr), tree(0) {}
+      ~ProfilingTree();
+
+      ProfilingTree(const ProfilingTree&) = delete;
+      ProfilingTree& operator=(const ProfilingTree&) = delete;
+
+      void capture(duckdb::ClientContext& context);
+      // nil when the query was not profiled
+      ERL_NIF_TERM get(ErlNifEnv* caller) const;
+
+    private:
+      ErlNifEnv* env;
+      ERL_NIF_TERM tree;
+  };
+
+  /*
+   * The profiler of the connection, shared by the connection and its prepared statements.
+   * Every enable (enable_profiling/1 or the query run with profile: true) is counted, the
+   * profiler is disabled when the last of them is disabled. The config is changed under the
+   * context lock without printing the tree of every query to stdout.
+   */
+  class Profiling {
+    public:
+      Profiling() : count(0), owned(false) {}
+
+      Profiling(const Profiling&) = delete;
+      Profiling& operator=(const Profiling&) = delete;
+
+      void enable(duckdb::ClientContext& context);
+      void disable(duckdb::ClientContext& context);
+
+    private:
+      std::mutex mutex;
+      unsigned count;
+      // the profiler was enabled by the first enable, not already by the sql (PRAGMA enable_profiling)
+      bool owned;
+  };
+
+  /*
+   * Enables the profiler of the connection for the scope of the query, so the profiling tree
+   * of the query can be taken after it. The queries on the connection take turns, the query
+   * holds its turn for the scope, so the queries of other processes are not profiled by it.
+   */
+  class QueryProfiling {
+    public:
+      QueryProfiling(Profiling& profiling, duckdb::ClientContext& context, bool enable);
+      ~QueryProfiling();
+
+      QueryProfiling(const QueryProfiling&) = delete;
+      QueryProfiling& operator=(const QueryProfiling&) = delete;
+
+    private:
+      Profiling& profiling;
+      duckdb::ClientContext& context;
+      bool enabled;
+  };
+}
@@ -0,0 +1,118 @@
+#include "query_options.h"
+#include "atoms.h"
+#include "term.h"
+
+namespace {
+  bool term_to_bool(ErlNifEnv* env, ERL_NIF_TERM term, bool& sink) {
+    if (term == nif::atoms.true_) {
+      sink = true;
+      return true;
+    }
+
+    if (term == nif::atoms.false_) {
+      sink = false;
+      return true;
+    }
+
+    return false;
+  }
+
+  bool term_to_timeout(ErlNifEnv* env, ERL_NIF_TERM term, unsigned long& sink) {
+    if (term == nif::atoms.infinity) {
+      sink = 0;
+      return true;
+    }
+
+    return enif_get_ulong(env, term, &sink) && sink;
+  }
+}
+
+bool nif::term_to_query_options(ErlNifEnv* env, ERL_NIF_TERM term, QueryOptions& sink) {
+  if (!enif_is_list(env, term))
+    return false;
+
+  ERL_NIF_TERM item, items = term;
+  while (enif_get_list_cell(env, items, &item, &items)) {
+    int arity = 0;
+    const ERL_NIF_TERM* option;
+    if (!enif_get_tuple(env, item, &arity, &option) || arity != 2)
+      return false;
+
+    if (option[0] == nif::atoms.stream) {
+      if (!term_to_bool(env, option[1], sink.stream))
+        return false;
+    } else if (option[0] == nif::atoms.cooperative) {
+      if (!term_to_bool(env, option[1], sink.cooperative))
+        return false;
+    } else if (option[0] == nif::atoms.timeout) {
+      if (!term_to_timeout(env, option[1], sink.timeout))
+        return false;
+    } else if (option[0] == nif::atoms.release_on_exit) {
+      if (!term_to_bool(env, option[1], sink.release_on_exit))
+        return false;
+    } else if (option[0] == nif::atoms.profile) {
+      if (!term_to_bool(env, option[1], sink.profile))
+        return false;
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool nif::term_to_execute_many_options(ErlNifEnv* env, ERL_NIF_TERM term, ExecuteManyOptions& sink) {
+  if (!enif_is_list(env, term))
+    return false;
+
+  ERL_NIF_TERM item, items = term;
+  while (enif_get_list_cell(env, items, &item, &items)) {
+    int arity = 0;
+    const ERL_NIF_TERM* option;
+    if (!enif_get_tuple(env, item, &arity, &option) || arity != 2)
+      return false;
+
+    if (option[0] == nif::atoms.transaction) {
+      if (!term_to_bool(env, option[1], sink.transaction))
+        return false;
+    } else if (option[0] == nif::atoms.timeout) {
+      if (!term_to_timeout(env, option[1], sink.timeout))
+        return false;
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool nif::term_to_async_appender_options(ErlNifEnv* env, ERL_NIF_TERM term, AsyncAppenderOptions& sink) {
+  if (!enif_is_list(env, term))
+    return false;
+
+  ERL_NIF_TERM item, items = term;
+  while (enif_get_list_cell(env, items, &item, &items)) {
+    int arity = 0;
+    const ERL_NIF_TERM* option;
+    if (!enif_get_tuple(env, item, &arity, &option) || arity != 2)
+      return false;
+
+    if (option[0] == nif::atoms.max_pending_rows) {
+      if (!enif_get_ulong(env, option[1], &sink.max_pending_rows) || !sink.max_pending_rows)
+        return false;
+    } else if (option[0] == nif::atoms.flush_rows) {
+      if (!enif_get_ulong(env, option[1], &sink.flush_rows))
+        return false;
+    } else if (option[0] == nif::atoms.flush_bytes) {
+      if (!enif_get_ulong(env, option[1], &sink.flush_bytes))
+        return false;
+    } else if (option[0] == nif::atoms.flush_interval) {
+      if (!term_to_timeout(env, option[1], sink.flush_interval))
+        return false;
+    } else {
+      return false;
+    }
+  }
+
+  return true;
+}
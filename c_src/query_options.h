@@ -0,0 +1,49 @@
+#pragma once
+#include <erl_nif.h>
+
+namespace nif {
+  /*
+   * Options of the query/execute NIFs given as the keyword list
+   */
+  struct QueryOptions {
+    // Return StreamQueryResult fetching chunks as the pipeline produces them
+    bool stream = false;
+    // Run the query step by step on the normal scheduler
+    bool cooperative = false;
+    // Interrupt the query running longer than that (milliseconds), 0 is no timeout
+    unsigned long timeout = 0;
+    // Release the result as soon as the calling process exits
+    bool release_on_exit = false;
+    // Enable the profiler for the query so its profiling tree can be taken after it
+    bool profile = false;
+  };
+
+  bool term_to_query_options(ErlNifEnv* env, ERL_NIF_TERM term, QueryOptions& sink);
+
+  /*
+   * Options of the execute_statement_many NIF
+   */
+  struct ExecuteManyOptions {
+    // Run all the rows in one transaction (unless one is already open)
+    bool transaction = false;
+    // Interrupt the batch running longer than that (milliseconds), 0 is no timeout
+    unsigned long timeout = 0;
+  };
+
+  bool term_to_execute_many_options(ErlNifEnv* env, ERL_NIF_TERM term, ExecuteManyOptions& sink);
+
+  /*
+   * Options of the async appender
+   */
+  struct AsyncAppenderOptions {
+    // The rows queued but not appended yet, adding more is refused
+    unsigned long max_pending_rows = 100000;
+    // Flush when that many rows (or bytes, roughly) are appended since the last flush, 0 is never
+    unsigned long flush_rows = 0;
+    unsigned long flush_bytes = 0;
+    // Flush the appended rows that are older than that (milliseconds), 0 is never
+    unsigned long flush_interval = 1000;
+  };
+
+  bool term_to_async_appender_options(ErlNifEnv* env, ERL_NIF_TERM term, AsyncAppenderOptions& sink);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <erl_nif.h>
+#include <mutex>
+
+namespace nif {
+  /*
+   * The process running the query on the client context. The context is shared by the
+   * connection and its prepared statements, so is the owner. The queries take the owner
+   * in turn (as DuckDB takes the context lock), the process waiting for its turn is not
+   * the owner, so its exit does not interrupt the query of another process.
+   */
+  class QueryOwner {
+    public:
+      QueryOwner() : active(false) {}
+
+      QueryOwner(const QueryOwner&) = delete;
+      QueryOwner& operator=(const QueryOwner&) = delete;
+
+      // Waits for the running query, pid is NULL if the caller is unknown
+      void acquire(const ErlNifPid* pid) {
+        running.lock();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        active = pid != nullptr;
+        if (pid)
+          owner = *pid;
+      }
+
+      // Takes the turn unless another query is running, the caller is not monitored
+      bool try_acquire() {
+        if (!running.try_lock())
+          return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        active = false;
+        return true;
+      }
+
+      void release() {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          active = false;
+        }
+
+        running.unlock();
+      }
+
+      bool is_owner(const ErlNifPid& pid) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return active && enif_compare_pids(&owner, &pid) == 0;
+      }
+
+      /*
+       * Holds the turn for the scope of the call which is not monitored (transaction control),
+       * with std::try_to_lock it does not wait for the running query (the cooperative step)
+       */
+      class Turn {
+        public:
+          Turn(QueryOwner& owner) : owner(owner), held(true) { owner.acquire(nullptr); }
+          Turn(QueryOwner& owner, std::try_to_lock_t) : owner(owner), held(owner.try_acquire()) {}
+          ~Turn() { if (held) owner.release(); }
+
+          Turn(const Turn&) = delete;
+          Turn& operator=(const Turn&) = delete;
+
+          bool owns() const { return held; }
+
+        private:
+          QueryOwner& owner;
+          bool held;
+      };
+
+    private:
+      std::mutex running;
+      std::mutex mutex;
+      ErlNifPid owner;
+      bool active;
+  };
+}
@@ -1,6 +1,12 @@
 #pragma once
 #include "duckdb.hpp"
+#include "params_binder.h"
+#include "profiling.h"
+#include "query_owner.h"
+#include "row_writer.h"
+#include "statement_cache.h"
 #include <erl_nif.h>
+#include <mutex>
 
 /*
  * Erlang resources
@@ -12,6 +18,9 @@ static ErlNifResourceType* connection_nif_type = nullptr;
 static ErlNifResourceType* query_result_nif_type = nullptr;
 static ErlNifResourceType* prepared_statement_nif_type = nullptr;
 static ErlNifResourceType* appender_nif_type = nullptr;
+static ErlNifResourceType* pending_query_nif_type = nullptr;
+static ErlNifResourceType* connection_pool_nif_type = nullptr;
+static ErlNifResourceType* async_appender_nif_type = nullptr;
 
 /*
  * Erlang resource holds DuckDB object
@@ -25,6 +34,93 @@ struct erlang_resource {
       : data(std::move(d)) {}
 };
 
+/*
+ * With erlang_allocator every database opened with the config gets its own
+ * counting allocator (DuckDB moves the allocator out of the config on open).
+ * The mutex serializes the opens and the option changes of the shared config.
+ */
+template<>
+struct erlang_resource<duckdb::DBConfig> {
+  std::unique_ptr<duckdb::DBConfig> data;
+  bool erlang_allocator;
+  std::mutex mutex;
+
+  erlang_resource(std::unique_ptr<duckdb::DBConfig> d)
+      : data(std::move(d)), erlang_allocator(false) {}
+};
+
+/*
+ * The connection keeps the prepared statements of query/3 (destroyed before the connection)
+ * and the owner of the running query shared with its prepared statements
+ */
+template<>
+struct erlang_resource<duckdb::Connection> {
+  std::unique_ptr<duckdb::Connection> data;
+  nif::StatementCache statements;
+  std::shared_ptr<nif::QueryOwner> owner;
+  std::shared_ptr<nif::Profiling> profiling;
+
+  erlang_resource(std::unique_ptr<duckdb::Connection> d)
+      : data(std::move(d)), owner(std::make_shared<nif::QueryOwner>()), profiling(std::make_shared<nif::Profiling>()) {}
+};
+
+/*
+ * The result can be released by the down callback when its owner exits,
+ * the mutex guards the result while it is in use. The cells of the fetched
+ * chunk are converted into the scratch kept between the fetches. The profiling
+ * tree of the query run with profile: true is taken with the result.
+ */
+template<>
+struct erlang_resource<duckdb::QueryResult> {
+  std::unique_ptr<duckdb::QueryResult> data;
+  std::mutex mutex;
+  std::vector<ERL_NIF_TERM> cells;
+  nif::ProfilingTree profiling_tree;
+
+  erlang_resource(std::unique_ptr<duckdb::QueryResult> d)
+      : data(std::move(d)) {}
+};
+
+/*
+ * The parameters of the statement are resolved once when it is prepared,
+ * the owner of the running query is the one of the connection
+ */
+template<>
+struct erlang_resource<duckdb::PreparedStatement> {
+  std::unique_ptr<duckdb::PreparedStatement> data;
+  nif::ParamsBinder binder;
+  std::shared_ptr<nif::QueryOwner> owner;
+  std::shared_ptr<nif::Profiling> profiling;
+
+  erlang_resource(std::unique_ptr<duckdb::PreparedStatement> d)
+      : data(std::move(d)), binder(*data), owner(std::make_shared<nif::QueryOwner>()), profiling(std::make_shared<nif::Profiling>()) {}
+};
+
+/*
+ * The cooperative query steps take the turn of the connection queries, the owner
+ * is the one of the connection
+ */
+template<>
+struct erlang_resource<duckdb::PendingQueryResult> {
+  std::unique_ptr<duckdb::PendingQueryResult> data;
+  std::shared_ptr<nif::QueryOwner> owner;
+
+  erlang_resource(std::unique_ptr<duckdb::PendingQueryResult> d)
+      : data(std::move(d)) {}
+};
+
+/*
+ * The column writers of the appender are resolved once when it is created
+ */
+template<>
+struct erlang_resource<duckdb::Appender> {
+  std::unique_ptr<duckdb::Appender> data;
+  nif::RowWriter writer;
+
+  erlang_resource(std::unique_ptr<duckdb::Appender> d)
+      : data(std::move(d)), writer(data->GetActiveTypes()) {}
+};
+
 template<class T>
 static void resource_destructor(ErlNifEnv*, void* arg) {
   auto* resource = static_cast<erlang_resource<T>*>(arg);
@@ -139,6 +235,14 @@ inline erlang_resource<duckdb::Appender>* get_resource(ErlNifEnv* env, ERL_NIF_T
   return nullptr;
 }
 
+template <>
+inline erlang_resource<duckdb::PendingQueryResult>* get_resource(ErlNifEnv* env, ERL_NIF_TERM term) {
+  erlang_resource<duckdb::PendingQueryResult>* resource = nullptr;
+  if(enif_get_resource(env, term, pending_query_nif_type, (void**)&resource) && resource->data)
+    return resource;
+  return nullptr;
+}
+
 template <class T>
 erlang_resource<T>* get_resource(ErlNifEnv* env, ERL_NIF_TERM term, ErlNifResourceType* resource_type) {
   erlang_resource<T>* resource = nullptr;
@@ -0,0 +1,137 @@
+#include "row_writer.h"
+#include "atoms.h"
+#include "term.h"
+#include "term_reader.h"
+#include "term_to_value.h"
+
+namespace {
+  template <class T, bool (*READ)(ErlNifEnv*, ERL_NIF_TERM, T&)>
+  bool write_typed(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType&, duckdb::BaseAppender& appender) {
+    T value;
+    if (!READ(env, term, value))
+      return false;
+
+    appender.Append<T>(value);
+    return true;
+  }
+
+  // Append<string_t> copies the string into the appender chunk without validating it
+  bool write_varchar(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType&, duckdb::BaseAppender& appender) {
+    ErlNifBinary bin;
+    if (enif_inspect_binary(env, term, &bin)) {
+      if (!nif::is_valid_utf8((const char*)bin.data, bin.size))
+        return false;
+
+      appender.Append<duckdb::string_t>(duckdb::string_t((const char*)bin.data, (uint32_t)bin.size));
+      return true;
+    }
+
+    std::string atom;
+    if (nif::atom_to_string(env, term, atom) && nif::is_valid_utf8(atom.data(), atom.size())) {
+      appender.Append<duckdb::string_t>(duckdb::string_t(atom.data(), (uint32_t)atom.size()));
+      return true;
+    }
+
+    return false;
+  }
+
+  bool write_value(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& type, duckdb::BaseAppender& appender) {
+    duckdb::Value value;
+    if (!nif::term_to_value(env, term, type, value))
+      return false;
+
+    appender.Append<duckdb::Value>(value);
+    return true;
+  }
+
+  bool is_nil(ErlNifEnv* env, ERL_NIF_TERM term) {
+    return term == nif::atoms.nil;
+  }
+
+  /*
+   * BaseAppender can't drop the row begun. Once its current column is back to the first one
+   * the cells written so far are overwritten by the next row (or never counted by EndRow).
+   */
+  struct RowDiscard : duckdb::BaseAppender {
+    static void discard(duckdb::BaseAppender& appender) {
+      appender.*(&RowDiscard::column) = 0;
+    }
+  };
+}
+
+nif::RowWriter::RowWriter(const duckdb::vector<duckdb::LogicalType>& types) {
+  columns.reserve(types.size());
+  for (auto& type : types) {
+    writer write;
+    switch (type.id()) {
+      case duckdb::LogicalTypeId::BOOLEAN:
+        write = write_typed<bool, read_bool>;
+        break;
+      case duckdb::LogicalTypeId::TINYINT:
+        write = write_typed<int8_t, read_int<int8_t>>;
+        break;
+      case duckdb::LogicalTypeId::SMALLINT:
+        write = write_typed<int16_t, read_int<int16_t>>;
+        break;
+      case duckdb::LogicalTypeId::INTEGER:
+        write = write_typed<int32_t, read_int<int32_t>>;
+        break;
+      case duckdb::LogicalTypeId::BIGINT:
+        write = write_typed<int64_t, read_int<int64_t>>;
+        break;
+      case duckdb::LogicalTypeId::UTINYINT:
+        write = write_typed<uint8_t, read_uint<uint8_t>>;
+        break;
+      case duckdb::LogicalTypeId::USMALLINT:
+        write = write_typed<uint16_t, read_uint<uint16_t>>;
+        break;
+      case duckdb::LogicalTypeId::UINTEGER:
+        write = write_typed<uint32_t, read_uint<uint32_t>>;
+        break;
+      case duckdb::LogicalTypeId::UBIGINT:
+        write = write_typed<uint64_t, read_uint<uint64_t>>;
+        break;
+      case duckdb::LogicalTypeId::FLOAT:
+        write = write_typed<float, read_real<float>>;
+        break;
+      case duckdb::LogicalTypeId::DOUBLE:
+        write = write_typed<double, read_real<double>>;
+        break;
+      case duckdb::LogicalTypeId::VARCHAR:
+        write = write_varchar;
+        break;
+      default:
+        write = write_value;
+    }
+
+    Column column = {type, write};
+    columns.push_back(std::move(column));
+  }
+}
+
+bool nif::RowWriter::append_row(ErlNifEnv* env, duckdb::BaseAppender& appender, ERL_NIF_TERM row, std::string& error) const {
+  appender.BeginRow();
+
+  try {
+    ERL_NIF_TERM item;
+    for (size_t column_idx = 0; enif_get_list_cell(env, row, &item, &row); column_idx++) {
+      const Column& column = columns[column_idx];
+
+      if (is_nil(env, item)) {
+        appender.Append<std::nullptr_t>(nullptr);
+      } else if (!column.write(env, item, column.type, appender)) {
+        error = "invalid type of column: " + std::to_string(column_idx);
+        RowDiscard::discard(appender);
+        return false;
+      }
+    }
+
+    appender.EndRow();
+  } catch (std::exception& ex) {
+    error = ex.what();
+    RowDiscard::discard(appender);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "duckdb.hpp"
+#include <erl_nif.h>
+#include <string>
+#include <vector>
+
+namespace nif {
+  /*
+   * Appends the rows of terms to the appender. The writer of every column is resolved
+   * once from the appender types: numeric, boolean and string cells are appended as
+   * the C values (Append<T>), the other types go through duckdb::Value.
+   */
+  class RowWriter {
+    public:
+      RowWriter(const duckdb::vector<duckdb::LogicalType>& types);
+
+      size_t size() const { return columns.size(); }
+
+      // The row must be the list of size() terms, on failure the error is set and the row
+      // is dropped, the appender is left as it was before the row
+      bool append_row(ErlNifEnv* env, duckdb::BaseAppender& appender, ERL_NIF_TERM row, std::string& error) const;
+
+    private:
+      typedef bool (*writer)(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& type, duckdb::BaseAppender& appender);
+
+      struct Column {
+        duckdb::LogicalType type;
+        writer write;
+      };
+
+      std::vector<Column> columns;
+  };
+}
@@ -0,0 +1,68 @@
+#include "statement_cache.h"
+
+nif::StatementCache::Statement nif::StatementCache::get(const std::string& sql) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = index.find(sql);
+  if (it == index.end()) {
+    misses++;
+    return nullptr;
+  }
+
+  hits++;
+  entries.splice(entries.begin(), entries, it->second);
+  return it->second->second;
+}
+
+void nif::StatementCache::put(const std::string& sql, Statement statement) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!capacity)
+    return;
+
+  auto it = index.find(sql);
+  if (it != index.end()) {
+    it->second->second = std::move(statement);
+    entries.splice(entries.begin(), entries, it->second);
+    return;
+  }
+
+  entries.emplace_front(sql, std::move(statement));
+  index[sql] = entries.begin();
+  evict();
+}
+
+void nif::StatementCache::remove(const std::string& sql) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  auto it = index.find(sql);
+  if (it != index.end()) {
+    entries.erase(it->second);
+    index.erase(it);
+  }
+}
+
+void nif::StatementCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  index.clear();
+  entries.clear();
+}
+
+void nif::StatementCache::resize(size_t new_capacity) {
+  std::lock_guard<std::mutex> lock(mutex);
+  capacity = new_capacity;
+  evict();
+}
+
+nif::StatementCache::Stats nif::StatementCache::stats() {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  Stats stats = {entries.size(), capacity, hits, misses};
+  return stats;
+}
+
+void nif::StatementCache::evict() {
+  while (entries.size() > capacity) {
+    index.erase(entries.back().first);
+    entries.pop_back();
+  }
+}
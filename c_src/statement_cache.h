@@ -0,0 +1,69 @@
+#pragma once
+#include "duckdb.hpp"
+#include "params_binder.h"
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace nif {
+  /*
+   * LRU cache of the prepared statements of the connection keyed by the SQL text.
+   * DuckDB rebinds a prepared statement by itself when the catalog entries it depends
+   * on are changed, the statement failed to execute is removed from the cache.
+   */
+  class StatementCache {
+    public:
+      // The statement is cached along with its parameters binding plan
+      struct Entry {
+        duckdb::unique_ptr<duckdb::PreparedStatement> statement;
+        ParamsBinder binder;
+
+        Entry(duckdb::unique_ptr<duckdb::PreparedStatement> s)
+          : statement(std::move(s)), binder(*statement) {}
+      };
+
+      typedef std::shared_ptr<Entry> Statement;
+
+      static const size_t DEFAULT_CAPACITY = 64;
+
+      struct Stats {
+        size_t size;
+        size_t capacity;
+        uint64_t hits;
+        uint64_t misses;
+      };
+
+      StatementCache() : capacity(DEFAULT_CAPACITY), hits(0), misses(0) {}
+
+      StatementCache(const StatementCache&) = delete;
+      StatementCache& operator=(const StatementCache&) = delete;
+
+      // Returns nullptr on miss
+      Statement get(const std::string& sql);
+      void put(const std::string& sql, Statement statement);
+      void remove(const std::string& sql);
+      void clear();
+
+      // 0 disables the cache
+      void resize(size_t capacity);
+
+      Stats stats();
+
+    private:
+      typedef std::list<std::pair<std::string, Statement>> Entries;
+
+      void evict();
+
+      std::mutex mutex;
+      size_t capacity;
+      // the most recently used first
+      Entries entries;
+      std::unordered_map<std::string, Entries::iterator> index;
+      uint64_t hits;
+      uint64_t misses;
+  };
+}
@@ -0,0 +1,58 @@
+#include "telemetry.h"
+#include "atoms.h"
+#include <mutex>
+
+namespace {
+  std::mutex collector_mutex;
+  ErlNifPid collector;
+}
+
+std::atomic<bool> nif::Telemetry::active(false);
+
+void nif::Telemetry::set_collector(const ErlNifPid* pid) {
+  std::lock_guard<std::mutex> lock(collector_mutex);
+  if (pid)
+    collector = *pid;
+
+  active.store(pid != nullptr, std::memory_order_relaxed);
+}
+
+bool nif::Telemetry::get_collector(ErlNifPid& pid) {
+  std::lock_guard<std::mutex> lock(collector_mutex);
+  if (!active.load(std::memory_order_relaxed))
+    return false;
+
+  pid = collector;
+  return true;
+}
+
+void nif::CallSpan::send() {
+  ErlNifPid pid;
+  if (!Telemetry::get_collector(pid))
+    return;
+
+  ErlNifEnv* msg_env = enif_alloc_env();
+  if (!msg_env)
+    return;
+
+  static const ERL_NIF_TERM* const phases[] = {
+    &atoms.queue, &atoms.prepare, &atoms.bind, &atoms.execute,
+    &atoms.fetch, &atoms.convert, &atoms.append, &atoms.flush
+  };
+
+  ERL_NIF_TERM measurements = enif_make_new_map(msg_env);
+  enif_make_map_put(msg_env, measurements, atoms.total, enif_make_int64(msg_env, now() - started_at), &measurements);
+  enif_make_map_put(msg_env, measurements, atoms.rows, enif_make_uint64(msg_env, rows), &measurements);
+  enif_make_map_put(msg_env, measurements, atoms.bytes, enif_make_uint64(msg_env, bytes), &measurements);
+
+  for (int phase = 0; phase < static_cast<int>(Phase::COUNT); phase++) {
+    if (marked & (1u << phase))
+      enif_make_map_put(msg_env, measurements, *phases[phase], enif_make_int64(msg_env, durations[phase]), &measurements);
+  }
+
+  // the atoms are not bound to the env
+  ERL_NIF_TERM message = enif_make_tuple3(msg_env, atoms.duckdbex_telemetry, event, measurements);
+
+  enif_send(caller_env, &pid, msg_env, message);
+  enif_free_env(msg_env);
+}
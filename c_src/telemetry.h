@@ -0,0 +1,88 @@
+#pragma once
+#include <erl_nif.h>
+#include <atomic>
+#include <cstdint>
+
+namespace nif {
+  // The phases of the NIF call, the order of the measurements keys (see telemetry.cpp)
+  enum class Phase { QUEUE, PREPARE, BIND, EXECUTE, FETCH, CONVERT, APPEND, FLUSH, COUNT };
+
+  /*
+   * The process collecting the timings of the NIF calls, there is no collector by default.
+   * Without the collector the spans do not read the clock.
+   */
+  class Telemetry {
+    public:
+      // nullptr removes the collector
+      static void set_collector(const ErlNifPid* pid);
+
+      static bool enabled() { return active.load(std::memory_order_relaxed); }
+
+      // Returns false if there is no collector
+      static bool get_collector(ErlNifPid& pid);
+
+    private:
+      static std::atomic<bool> active;
+  };
+
+  /*
+   * The phase timings of one NIF call. Every mark() ends the phase started by the previous
+   * mark (or by the span) at now and adds its time to the phase. The span is sent to the
+   * collector when it goes out of scope as
+   * {:duckdbex_telemetry, event, %{total: ns, rows: n, bytes: n, <phase>: ns, ...}}
+   * with the marked phases only. `caller_env` is the env given to enif_send.
+   */
+  class CallSpan {
+    public:
+      CallSpan(ErlNifEnv* caller_env, ERL_NIF_TERM event, int64_t queued_at = 0)
+        : enabled(Telemetry::enabled()), caller_env(caller_env), event(event), rows(0), bytes(0), marked(0), started_at(0), last_at(0) {
+        if (!enabled)
+          return;
+
+        started_at = last_at = now();
+        if (queued_at)
+          add(Phase::QUEUE, started_at - queued_at);
+      }
+
+      ~CallSpan() { if (enabled) send(); }
+
+      CallSpan(const CallSpan&) = delete;
+      CallSpan& operator=(const CallSpan&) = delete;
+
+      void mark(Phase phase) {
+        if (!enabled)
+          return;
+
+        int64_t at = now();
+        add(phase, at - last_at);
+        last_at = at;
+      }
+
+      void add_rows(uint64_t count) { rows += count; }
+      void add_bytes(uint64_t count) { bytes += count; }
+
+      static int64_t now() { return enif_monotonic_time(ERL_NIF_NSEC); }
+
+    private:
+      void add(Phase phase, int64_t duration) {
+        unsigned bit = 1u << static_cast<int>(phase);
+        if (!(marked & bit))
+          durations[static_cast<int>(phase)] = 0;
+
+        durations[static_cast<int>(phase)] += duration;
+        marked |= bit;
+      }
+
+      void send();
+
+      bool enabled;
+      ErlNifEnv* caller_env;
+      ERL_NIF_TERM event;
+      uint64_t rows;
+      uint64_t bytes;
+      unsigned marked;
+      int64_t started_at;
+      int64_t last_at;
+      int64_t durations[static_cast<int>(Phase::COUNT)];
+  };
+}
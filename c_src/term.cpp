@@ -1,4 +1,5 @@
 #include "term.h"
+#include "atoms.h"
 #include <cassert>
 #include <cstring>
 #include <erl_nif.h>
@@ -63,7 +64,7 @@ nif::make_ok_tuple(ErlNifEnv* env, ERL_NIF_TERM value) {
   assert(env);
   assert(value);
 
-  return enif_make_tuple2(env, nif::make_atom(env, "ok"), value);
+  return enif_make_tuple2(env, nif::atoms.ok, value);
 }
 
 ERL_NIF_TERM
@@ -71,7 +72,7 @@ nif::make_error_tuple(ErlNifEnv* env, ERL_NIF_TERM value) {
   assert(env);
   assert(value);
 
-  return enif_make_tuple2(env, nif::make_atom(env, "error"), value);
+  return enif_make_tuple2(env, nif::atoms.error, value);
 }
 
 ERL_NIF_TERM
@@ -94,7 +95,7 @@ nif::make_binary_term(ErlNifEnv* env, const char* cstr, size_t len) {
     std::memcpy(enif_make_new_binary(env, len, &result), cstr, len);
     return result;
   } else {
-    return enif_make_atom(env, "nil");
+    return nif::atoms.nil;
   };
 }
 
@@ -107,15 +108,12 @@ bool nif::is_atom(ErlNifEnv* env, ERL_NIF_TERM term, const char* expected_atom)
   if (!enif_is_atom(env, term))
     return false;
 
-  unsigned atom_len = 0;
-  if (!enif_get_atom_length(env, term, &atom_len, ERL_NIF_LATIN1))
-    return false;
-
-  std::vector<char> atom(atom_len + 1);
-  if(!enif_get_atom(env, term, &atom[0], atom.size(), ERL_NIF_LATIN1))
+  // the atom is at most 255 characters
+  char atom[256];
+  if(!enif_get_atom(env, term, atom, sizeof(atom), ERL_NIF_LATIN1))
     return false;
 
-  return std::strcmp(&atom[0], expected_atom) == 0;
+  return std::strcmp(atom, expected_atom) == 0;
 }
 
 bool nif::atom_to_string(ErlNifEnv* env, ERL_NIF_TERM term, std::string& sink) {
@@ -0,0 +1,71 @@
+#pragma once
+#include "atoms.h"
+#include "term.h"
+#include "utf8proc_wrapper.hpp"
+#include <erl_nif.h>
+#include <limits>
+
+/*
+ * Reading the terms into the C types the DuckDB vectors store, the integers are
+ * range checked, the floating point types take the integers too (as term_to_double does)
+ */
+
+namespace nif {
+  template <class T>
+  inline bool read_int(ErlNifEnv* env, ERL_NIF_TERM term, T& sink) {
+    ErlNifSInt64 value;
+    if (!enif_get_int64(env, term, &value) ||
+        value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max())
+      return false;
+
+    sink = static_cast<T>(value);
+    return true;
+  }
+
+  template <class T>
+  inline bool read_uint(ErlNifEnv* env, ERL_NIF_TERM term, T& sink) {
+    ErlNifUInt64 value;
+    if (!enif_get_uint64(env, term, &value) || value > std::numeric_limits<T>::max())
+      return false;
+
+    sink = static_cast<T>(value);
+    return true;
+  }
+
+  template <class T>
+  inline bool read_real(ErlNifEnv* env, ERL_NIF_TERM term, T& sink) {
+    double a_double;
+    if (enif_get_double(env, term, &a_double)) {
+      sink = static_cast<T>(a_double);
+      return true;
+    }
+
+    ErlNifSInt64 an_int64;
+    if (enif_get_int64(env, term, &an_int64)) {
+      sink = static_cast<T>(an_int64);
+      return true;
+    }
+
+    return false;
+  }
+
+  inline bool read_bool(ErlNifEnv* env, ERL_NIF_TERM term, bool& sink) {
+    if (term == nif::atoms.true_) {
+      sink = true;
+      return true;
+    }
+
+    if (term == nif::atoms.false_) {
+      sink = false;
+      return true;
+    }
+
+    return false;
+  }
+
+  // The strings written into the vectors or the appender directly are not validated by DuckDB,
+  // the VARCHAR must be UTF-8 as Value(std::string) checks it (the latin1 atoms may not be)
+  inline bool is_valid_utf8(const char* data, size_t size) {
+    return duckdb::Utf8Proc::Analyze(data, size) != duckdb::UnicodeType::INVALID;
+  }
+}
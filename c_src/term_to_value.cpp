@@ -2,7 +2,10 @@
 #include "duckdb.hpp"
 #include "duckdb/common/types/time.hpp"
 #include "duckdb/common/types/uuid.hpp"
+#include "atoms.h"
 #include "term.h"
+#include "vector_to_term.h"
+#include <cstring>
 
 namespace {
   template <class T>
@@ -107,18 +110,7 @@ bool nif::atom_to_string(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Value& sink)
 }
 
 bool nif::term_to_null(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Value& sink) {
-  unsigned atom_len = 0;
-  if (!enif_get_atom_length(env, term, &atom_len, ERL_NIF_LATIN1))
-    return false;
-
-  if(atom_len != 3)
-    return false;
-
-  std::vector<char> atom(4);
-  if(!enif_get_atom(env, term, &atom[0], 4, ERL_NIF_LATIN1))
-    return false;
-
-  if (!std::strcmp(&atom[0], "nil")) {
+  if (term == nif::atoms.nil) {
     sink = std::move(duckdb::Value(duckdb::LogicalType::SQLNULL));
     return true;
   }
@@ -127,20 +119,12 @@ bool nif::term_to_null(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Value& sink) {
 }
 
 bool nif::term_to_boolean(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Value& sink) {
-  unsigned atom_len = 0;
-  if (!enif_get_atom_length(env, term, &atom_len, ERL_NIF_LATIN1))
-    return false;
-
-  std::vector<char> atom(atom_len + 1);
-  if(!enif_get_atom(env, term, &atom[0], atom.size(), ERL_NIF_LATIN1))
-    return false;
-
-  if (!std::strcmp(&atom[0], "true")) {
+  if (term == nif::atoms.true_) {
     sink = std::move(duckdb::Value::BOOLEAN(true));
     return true;
   }
 
-  if (!std::strcmp(&atom[0], "false")) {
+  if (term == nif::atoms.false_) {
     sink = std::move(duckdb::Value::BOOLEAN(false));
     return true;
   }
@@ -774,12 +758,51 @@ bool nif::term_to_interval(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Value& sin
   return false;
 }
 
+namespace {
+  /*
+   * The binary of the fixed-width elements in the native-endian layout
+   * (as returned by the fetch_chunk_packed) is converted into the values.
+   */
+  bool packed_term_to_values(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& child_type, duckdb::vector<duckdb::Value>& values) {
+    ErlNifBinary bin;
+    if (!nif::is_packable(child_type) || !enif_inspect_binary(env, term, &bin))
+      return false;
+
+    duckdb::idx_t width = duckdb::GetTypeIdSize(child_type.InternalType());
+    if (bin.size % width)
+      return false;
+
+    duckdb::idx_t length = bin.size / width;
+    duckdb::Vector vector(child_type, std::max<duckdb::idx_t>(length, 1));
+    auto data = duckdb::FlatVector::GetData<uint8_t>(vector);
+    std::memcpy(data, bin.data, bin.size);
+
+    if (child_type.id() == duckdb::LogicalTypeId::BOOLEAN) {
+      for (size_t idx = 0; idx < bin.size; idx++)
+        data[idx] = data[idx] ? 1 : 0;
+    }
+
+    values.clear();
+    values.reserve(length);
+    for (duckdb::idx_t i = 0; i < length; i++)
+      values.push_back(vector.GetValue(i));
+
+    return true;
+  }
+}
+
 bool nif::term_to_list(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& list_type, duckdb::Value& sink) {
+  duckdb::LogicalType child_type = duckdb::ListType::GetChildType(list_type);
+
+  duckdb::vector<duckdb::Value> packed;
+  if (packed_term_to_values(env, term, child_type, packed)) {
+    sink = std::move(duckdb::Value::LIST(child_type, packed));
+    return true;
+  }
+
   if (!enif_is_list(env, term))
     return false;
 
-  duckdb::LogicalType child_type = duckdb::ListType::GetChildType(list_type);
-
   unsigned list_length = 0;
   if (!enif_get_list_length(env, term, &list_length))
     return false;
@@ -809,11 +832,17 @@ bool nif::term_to_list(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalT
 }
 
 bool nif::term_to_array(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& list_type, duckdb::Value& sink) {
+  duckdb::LogicalType child_type = duckdb::ListType::GetChildType(list_type);
+
+  duckdb::vector<duckdb::Value> packed;
+  if (packed_term_to_values(env, term, child_type, packed)) {
+    sink = std::move(duckdb::Value::ARRAY(child_type, packed));
+    return true;
+  }
+
   if (!enif_is_list(env, term))
     return false;
 
-  duckdb::LogicalType child_type = duckdb::ListType::GetChildType(list_type);
-
   unsigned list_length = 0;
   if (!enif_get_list_length(env, term, &list_length))
     return false;
@@ -944,6 +973,12 @@ bool nif::term_to_union(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::Logical
   return true;
 }
 
+namespace {
+  bool term_to_varchar(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Value& sink) {
+    return nif::term_to_string(env, term, sink) || nif::atom_to_string(env, term, sink);
+  }
+}
+
 bool nif::term_to_value(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& value_type, duckdb::Value& sink) {
   if(term_to_null(env, term, sink))
     return true;
@@ -953,109 +988,92 @@ bool nif::term_to_value(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::Logical
   // std::cout << "term_to_value: value enum code: " << unsigned(static_cast<std::underlying_type<duckdb::LogicalTypeId>::type>(value_type.id())) << std::endl;
   // </dbg>
 
+  if (auto convert = get_term_converter(value_type))
+    return convert(env, term, sink);
+
+  // the nested types are converted with their LogicalType
   switch(value_type.id()) {
-    case duckdb::LogicalTypeId::SQLNULL:
-      return term_to_null(env, term, sink);
+    case duckdb::LogicalTypeId::LIST:
+      return term_to_list(env, term, value_type, sink);
 
-    case duckdb::LogicalTypeId::BOOLEAN:
-      return term_to_boolean(env, term, sink);
+    case duckdb::LogicalTypeId::ARRAY:
+      return term_to_array(env, term, value_type, sink);
 
-    case duckdb::LogicalTypeId::UUID:
-      return term_to_uuid(env, term, sink);
+    case duckdb::LogicalTypeId::MAP:
+      return term_to_map(env, term, value_type, sink);
 
-    case duckdb::LogicalTypeId::FLOAT:
-      return term_to_float(env, term, sink);
+    case duckdb::LogicalTypeId::STRUCT:
+      return term_to_struct(env, term, value_type, sink);
 
-    case duckdb::LogicalTypeId::DOUBLE:
-      return term_to_double(env, term, sink);
+    case duckdb::LogicalTypeId::UNION:
+      return term_to_union(env, term, value_type, sink);
 
-    case duckdb::LogicalTypeId::DECIMAL:
-      return term_to_decimal(env, term, sink);
+    default:
+      return false;
+  };
+}
 
+nif::term_converter nif::get_term_converter(const duckdb::LogicalType& value_type) {
+  switch(value_type.id()) {
+    case duckdb::LogicalTypeId::SQLNULL:
+      return term_to_null;
+    case duckdb::LogicalTypeId::BOOLEAN:
+      return term_to_boolean;
+    case duckdb::LogicalTypeId::UUID:
+      return term_to_uuid;
+    case duckdb::LogicalTypeId::FLOAT:
+      return term_to_float;
+    case duckdb::LogicalTypeId::DOUBLE:
+      return term_to_double;
+    case duckdb::LogicalTypeId::DECIMAL:
+      return term_to_decimal;
     case duckdb::LogicalTypeId::BIGINT:
-      return term_to_bigint(env, term, sink);
-
+      return term_to_bigint;
     case duckdb::LogicalTypeId::UBIGINT:
-      return term_to_ubigint(env, term, sink);
-
+      return term_to_ubigint;
     case duckdb::LogicalTypeId::INTEGER:
-      return term_to_integer(env, term, sink);
-
+      return term_to_integer;
     case duckdb::LogicalTypeId::UINTEGER:
-      return term_to_uinteger(env, term, sink);
-
+      return term_to_uinteger;
     case duckdb::LogicalTypeId::SMALLINT:
-      return term_to_smallint(env, term, sink);
-
+      return term_to_smallint;
     case duckdb::LogicalTypeId::USMALLINT:
-      return term_to_usmallint(env, term, sink);
-
+      return term_to_usmallint;
     case duckdb::LogicalTypeId::TINYINT:
-      return term_to_tinyint(env, term, sink);
-
+      return term_to_tinyint;
     case duckdb::LogicalTypeId::UTINYINT:
-      return term_to_utinyint(env, term, sink);
-
+      return term_to_utinyint;
     case duckdb::LogicalTypeId::HUGEINT:
-      return term_to_hugeint(env, term, sink);
-
+      return term_to_hugeint;
     case duckdb::LogicalTypeId::UHUGEINT:
-      return term_to_uhugeint(env, term, sink);
-
+      return term_to_uhugeint;
     case duckdb::LogicalTypeId::CHAR:
     case duckdb::LogicalTypeId::VARCHAR:
     case duckdb::LogicalTypeId::ENUM:
-      return term_to_string(env, term, sink) || atom_to_string(env, term, sink);
-
+      return term_to_varchar;
     case duckdb::LogicalTypeId::DATE:
-      return term_to_date(env, term, sink);
-
+      return term_to_date;
     case duckdb::LogicalTypeId::TIME:
-      return term_to_time(env, term, sink);
-
+      return term_to_time;
     case duckdb::LogicalTypeId::TIME_TZ:
-      return term_to_time_tz(env, term, sink);
-
+      return term_to_time_tz;
     case duckdb::LogicalTypeId::TIMESTAMP:
-      return term_to_timestamp(env, term, sink);
-
+      return term_to_timestamp;
     case duckdb::LogicalTypeId::TIMESTAMP_TZ:
-      return term_to_timestamp_tz(env, term, sink);
-
+      return term_to_timestamp_tz;
     case duckdb::LogicalTypeId::TIMESTAMP_NS:
-      return term_to_timestamp_ns(env, term, sink);
-
+      return term_to_timestamp_ns;
     case duckdb::LogicalTypeId::TIMESTAMP_MS:
-      return term_to_timestamp_ms(env, term, sink);
-
+      return term_to_timestamp_ms;
     case duckdb::LogicalTypeId::TIMESTAMP_SEC:
-      return term_to_timestamp_sec(env, term, sink);
-
+      return term_to_timestamp_sec;
     case duckdb::LogicalTypeId::BLOB:
-      return term_to_blob(env, term, sink);
-
+      return term_to_blob;
     case duckdb::LogicalTypeId::INTERVAL:
-      return term_to_interval(env, term, sink);
-
+      return term_to_interval;
     case duckdb::LogicalTypeId::ANY:
-      return term_to_any(env, term, sink);
-
-    case duckdb::LogicalTypeId::LIST:
-      return term_to_list(env, term, value_type, sink);
-
-    case duckdb::LogicalTypeId::ARRAY:
-      return term_to_array(env, term, value_type, sink);
-
-    case duckdb::LogicalTypeId::MAP:
-      return term_to_map(env, term, value_type, sink);
-
-    case duckdb::LogicalTypeId::STRUCT:
-      return term_to_struct(env, term, value_type, sink);
-
-    case duckdb::LogicalTypeId::UNION:
-      return term_to_union(env, term, value_type, sink);
-
+      return term_to_any;
     default:
-      return false;
-  };
+      return nullptr;
+  }
 }
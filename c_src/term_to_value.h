@@ -44,4 +44,12 @@ namespace nif {
   bool term_to_union(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& union_type, duckdb::Value& sink);
 
   bool term_to_value(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& value_type, duckdb::Value& sink);
+
+  typedef bool (*term_converter)(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Value& sink);
+
+  /*
+   * Resolves the converter of the scalar type (without the nil check), term_to_value dispatches
+   * through it. nullptr for the types which need the LogicalType to be converted (nested ones).
+   */
+  term_converter get_term_converter(const duckdb::LogicalType& value_type);
 }
@@ -0,0 +1,404 @@
+#include "term_to_vector.h"
+#include "atoms.h"
+#include "term.h"
+#include "term_reader.h"
+#include "term_to_value.h"
+#include "vector_to_term.h"
+#include <cstring>
+
+namespace {
+  template <class T, bool (*READ)(ErlNifEnv*, ERL_NIF_TERM, T&)>
+  bool typed_terms_to_vector(ErlNifEnv* env, ERL_NIF_TERM& items, duckdb::Vector& vector, duckdb::idx_t count) {
+    auto data = duckdb::FlatVector::GetData<T>(vector);
+    auto& validity = duckdb::FlatVector::Validity(vector);
+
+    ERL_NIF_TERM item;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      if (!enif_get_list_cell(env, items, &item, &items))
+        return false;
+
+      if (item == nif::atoms.nil)
+        validity.SetInvalid(row);
+      else if (!READ(env, item, data[row]))
+        return false;
+    }
+
+    return true;
+  }
+
+  /*
+   * The binary is referenced by the string_t instead of being copied into the vector heap
+   * (only the strings up to string_t::INLINE_LENGTH are inlined). The vectors live only for
+   * the NIF call, AppendDataChunk copies the strings into the appender collection, so the
+   * large binaries are copied once.
+   */
+  inline duckdb::string_t binary_to_string_t(const ErlNifBinary& bin) {
+    return duckdb::string_t((const char*)bin.data, (uint32_t)bin.size);
+  }
+
+  // AppendDataChunk does not validate the strings
+  inline bool is_valid_utf8(const ErlNifBinary& bin) {
+    return nif::is_valid_utf8((const char*)bin.data, bin.size);
+  }
+
+  // VARCHAR takes binaries and atoms, BLOB takes iolists
+  bool string_terms_to_vector(ErlNifEnv* env, ERL_NIF_TERM& items, duckdb::Vector& vector, duckdb::idx_t count) {
+    auto data = duckdb::FlatVector::GetData<duckdb::string_t>(vector);
+    auto& validity = duckdb::FlatVector::Validity(vector);
+    bool is_blob = vector.GetType().id() == duckdb::LogicalTypeId::BLOB;
+
+    ERL_NIF_TERM item;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      if (!enif_get_list_cell(env, items, &item, &items))
+        return false;
+
+      ErlNifBinary bin;
+      std::string atom;
+      if (item == nif::atoms.nil)
+        validity.SetInvalid(row);
+      else if (is_blob ? enif_inspect_iolist_as_binary(env, item, &bin) : enif_inspect_binary(env, item, &bin)) {
+        if (!is_blob && !is_valid_utf8(bin))
+          return false;
+        data[row] = binary_to_string_t(bin);
+      }
+      else if (!is_blob && nif::atom_to_string(env, item, atom) && nif::is_valid_utf8(atom.data(), atom.size()))
+        data[row] = duckdb::StringVector::AddString(vector, atom.data(), atom.size());
+      else
+        return false;
+    }
+
+    return true;
+  }
+
+  bool term_to_vector_row(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Vector& vector, duckdb::idx_t row);
+
+  template <class T, bool (*READ)(ErlNifEnv*, ERL_NIF_TERM, T&)>
+  bool typed_term_to_vector_row(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Vector& vector, duckdb::idx_t row) {
+    return READ(env, term, duckdb::FlatVector::GetData<T>(vector)[row]);
+  }
+
+  bool string_term_to_vector_row(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Vector& vector, duckdb::idx_t row) {
+    ErlNifBinary bin;
+    std::string atom;
+    bool is_blob = vector.GetType().id() == duckdb::LogicalTypeId::BLOB;
+
+    if (is_blob ? enif_inspect_iolist_as_binary(env, term, &bin) : enif_inspect_binary(env, term, &bin)) {
+      if (!is_blob && !is_valid_utf8(bin))
+        return false;
+      duckdb::FlatVector::GetData<duckdb::string_t>(vector)[row] = binary_to_string_t(bin);
+    } else if (!is_blob && nif::atom_to_string(env, term, atom) && nif::is_valid_utf8(atom.data(), atom.size()))
+      duckdb::FlatVector::GetData<duckdb::string_t>(vector)[row] = duckdb::StringVector::AddString(vector, atom.data(), atom.size());
+    else
+      return false;
+
+    return true;
+  }
+
+  /*
+   * The binary of the fixed-width elements in the native-endian layout (LIST or ARRAY
+   * of the packable type) is copied into the child vector at the offset
+   */
+  void copy_packed(const ErlNifBinary& bin, duckdb::Vector& child, duckdb::idx_t offset) {
+    duckdb::idx_t width = duckdb::GetTypeIdSize(child.GetType().InternalType());
+    auto data = duckdb::FlatVector::GetData<uint8_t>(child) + offset * width;
+    std::memcpy(data, bin.data, bin.size);
+
+    // any non zero byte is true
+    if (child.GetType().id() == duckdb::LogicalTypeId::BOOLEAN) {
+      for (size_t idx = 0; idx < bin.size; idx++)
+        data[idx] = data[idx] ? 1 : 0;
+    }
+  }
+
+  /*
+   * The items of the list are appended to the child vector of the LIST vector,
+   * the pairs of the map ({key, value} tuples) to the key and value vectors of
+   * the MAP child (LIST of STRUCT(key, value)).
+   */
+  bool list_term_to_vector_row(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Vector& vector, duckdb::idx_t row) {
+    bool is_map = vector.GetType().id() == duckdb::LogicalTypeId::MAP;
+
+    duckdb::idx_t offset = duckdb::ListVector::GetListSize(vector);
+
+    ErlNifBinary bin;
+    if (!is_map && enif_inspect_binary(env, term, &bin)) {
+      auto& child_type = duckdb::ListType::GetChildType(vector.GetType());
+      if (!nif::is_packable(child_type))
+        return false;
+
+      duckdb::idx_t width = duckdb::GetTypeIdSize(child_type.InternalType());
+      if (bin.size % width)
+        return false;
+
+      duckdb::idx_t length = bin.size / width;
+      duckdb::ListVector::Reserve(vector, offset + length);
+      copy_packed(bin, duckdb::ListVector::GetEntry(vector), offset);
+
+      duckdb::FlatVector::GetData<duckdb::list_entry_t>(vector)[row] = duckdb::list_entry_t(offset, length);
+      duckdb::ListVector::SetListSize(vector, offset + length);
+      return true;
+    }
+
+    unsigned length = 0;
+    if (!enif_get_list_length(env, term, &length))
+      return false;
+    duckdb::ListVector::Reserve(vector, offset + length);
+
+    auto& child = duckdb::ListVector::GetEntry(vector);
+
+    ERL_NIF_TERM item, items = term;
+    for (duckdb::idx_t idx = offset; enif_get_list_cell(env, items, &item, &items); idx++) {
+      if (!is_map) {
+        if (!term_to_vector_row(env, item, child, idx))
+          return false;
+
+        continue;
+      }
+
+      int arity = 0;
+      const ERL_NIF_TERM* pair;
+      auto& entries = duckdb::StructVector::GetEntries(child);
+      if (!enif_get_tuple(env, item, &arity, &pair) || arity != 2 ||
+          !term_to_vector_row(env, pair[0], *entries[0], idx) ||
+          !term_to_vector_row(env, pair[1], *entries[1], idx))
+        return false;
+    }
+
+    duckdb::FlatVector::GetData<duckdb::list_entry_t>(vector)[row] = duckdb::list_entry_t(offset, length);
+    duckdb::ListVector::SetListSize(vector, offset + length);
+
+    return true;
+  }
+
+  // The elements of the row `i` are at [i * size, (i + 1) * size) of the child vector
+  bool array_term_to_vector_row(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Vector& vector, duckdb::idx_t row) {
+    duckdb::idx_t size = duckdb::ArrayType::GetSize(vector.GetType());
+
+    ErlNifBinary bin;
+    if (enif_inspect_binary(env, term, &bin)) {
+      auto& child_type = duckdb::ArrayType::GetChildType(vector.GetType());
+      if (!nif::is_packable(child_type) || bin.size != size * duckdb::GetTypeIdSize(child_type.InternalType()))
+        return false;
+
+      copy_packed(bin, duckdb::ArrayVector::GetEntry(vector), row * size);
+      return true;
+    }
+
+    unsigned length = 0;
+    if (!enif_get_list_length(env, term, &length) || length != size)
+      return false;
+
+    auto& child = duckdb::ArrayVector::GetEntry(vector);
+
+    ERL_NIF_TERM item, items = term;
+    for (duckdb::idx_t idx = row * size; enif_get_list_cell(env, items, &item, &items); idx++) {
+      if (!term_to_vector_row(env, item, child, idx))
+        return false;
+    }
+
+    return true;
+  }
+
+  // The map with the binary keys of the struct fields, all the fields must be there
+  bool struct_term_to_vector_row(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Vector& vector, duckdb::idx_t row) {
+    if (!enif_is_map(env, term))
+      return false;
+
+    auto& entries = duckdb::StructVector::GetEntries(vector);
+    for (duckdb::idx_t child_idx = 0; child_idx < entries.size(); child_idx++) {
+      auto& field_name = duckdb::StructType::GetChildName(vector.GetType(), child_idx);
+
+      ERL_NIF_TERM value;
+      if (!enif_get_map_value(env, term, nif::make_binary_term(env, field_name), &value) ||
+          !term_to_vector_row(env, value, *entries[child_idx], row))
+        return false;
+    }
+
+    return true;
+  }
+
+  /*
+   * Writes the single term into the row of the flat vector, the nested terms are written
+   * straight into the child vectors without building the duckdb::Value trees
+   */
+  bool term_to_vector_row(ErlNifEnv* env, ERL_NIF_TERM term, duckdb::Vector& vector, duckdb::idx_t row) {
+    if (term == nif::atoms.nil) {
+      if (vector.GetType().InternalType() == duckdb::PhysicalType::LIST)
+        duckdb::FlatVector::GetData<duckdb::list_entry_t>(vector)[row] = duckdb::list_entry_t(duckdb::ListVector::GetListSize(vector), 0);
+
+      duckdb::FlatVector::SetNull(vector, row, true);
+      return true;
+    }
+
+    switch (vector.GetType().id()) {
+      case duckdb::LogicalTypeId::BOOLEAN:
+        return typed_term_to_vector_row<bool, nif::read_bool>(env, term, vector, row);
+      case duckdb::LogicalTypeId::TINYINT:
+        return typed_term_to_vector_row<int8_t, nif::read_int<int8_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::SMALLINT:
+        return typed_term_to_vector_row<int16_t, nif::read_int<int16_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::INTEGER:
+        return typed_term_to_vector_row<int32_t, nif::read_int<int32_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::BIGINT:
+        return typed_term_to_vector_row<int64_t, nif::read_int<int64_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::UTINYINT:
+        return typed_term_to_vector_row<uint8_t, nif::read_uint<uint8_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::USMALLINT:
+        return typed_term_to_vector_row<uint16_t, nif::read_uint<uint16_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::UINTEGER:
+        return typed_term_to_vector_row<uint32_t, nif::read_uint<uint32_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::UBIGINT:
+        return typed_term_to_vector_row<uint64_t, nif::read_uint<uint64_t>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::FLOAT:
+        return typed_term_to_vector_row<float, nif::read_real<float>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::DOUBLE:
+        return typed_term_to_vector_row<double, nif::read_real<double>>(env, term, vector, row);
+      case duckdb::LogicalTypeId::VARCHAR:
+      case duckdb::LogicalTypeId::BLOB:
+        return string_term_to_vector_row(env, term, vector, row);
+      case duckdb::LogicalTypeId::LIST:
+      case duckdb::LogicalTypeId::MAP:
+        return list_term_to_vector_row(env, term, vector, row);
+      case duckdb::LogicalTypeId::ARRAY:
+        return array_term_to_vector_row(env, term, vector, row);
+      case duckdb::LogicalTypeId::STRUCT:
+        return struct_term_to_vector_row(env, term, vector, row);
+      default: {
+        duckdb::Value value;
+        if (!nif::term_to_value(env, term, vector.GetType(), value))
+          return false;
+
+        vector.SetValue(row, value);
+        return true;
+      }
+    }
+  }
+
+  bool nested_terms_to_vector(ErlNifEnv* env, ERL_NIF_TERM& items, duckdb::Vector& vector, duckdb::idx_t count) {
+    ERL_NIF_TERM item;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      if (!enif_get_list_cell(env, items, &item, &items) || !term_to_vector_row(env, item, vector, row))
+        return false;
+    }
+
+    return true;
+  }
+
+  bool generic_terms_to_vector(ErlNifEnv* env, ERL_NIF_TERM& items, duckdb::Vector& vector, duckdb::idx_t count) {
+    ERL_NIF_TERM item;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      if (!enif_get_list_cell(env, items, &item, &items))
+        return false;
+
+      duckdb::Value value;
+      if (!nif::term_to_value(env, item, vector.GetType(), value))
+        return false;
+
+      vector.SetValue(row, value);
+    }
+
+    return true;
+  }
+}
+
+bool nif::terms_to_vector(ErlNifEnv* env, ERL_NIF_TERM& items, duckdb::Vector& vector, duckdb::idx_t count) {
+  switch (vector.GetType().id()) {
+    case duckdb::LogicalTypeId::BOOLEAN:
+      return typed_terms_to_vector<bool, nif::read_bool>(env, items, vector, count);
+    case duckdb::LogicalTypeId::TINYINT:
+      return typed_terms_to_vector<int8_t, nif::read_int<int8_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::SMALLINT:
+      return typed_terms_to_vector<int16_t, nif::read_int<int16_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::INTEGER:
+      return typed_terms_to_vector<int32_t, nif::read_int<int32_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::BIGINT:
+      return typed_terms_to_vector<int64_t, nif::read_int<int64_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::UTINYINT:
+      return typed_terms_to_vector<uint8_t, nif::read_uint<uint8_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::USMALLINT:
+      return typed_terms_to_vector<uint16_t, nif::read_uint<uint16_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::UINTEGER:
+      return typed_terms_to_vector<uint32_t, nif::read_uint<uint32_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::UBIGINT:
+      return typed_terms_to_vector<uint64_t, nif::read_uint<uint64_t>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::FLOAT:
+      return typed_terms_to_vector<float, nif::read_real<float>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::DOUBLE:
+      return typed_terms_to_vector<double, nif::read_real<double>>(env, items, vector, count);
+    case duckdb::LogicalTypeId::VARCHAR:
+    case duckdb::LogicalTypeId::BLOB:
+      return string_terms_to_vector(env, items, vector, count);
+    case duckdb::LogicalTypeId::LIST:
+    case duckdb::LogicalTypeId::MAP:
+    case duckdb::LogicalTypeId::ARRAY:
+    case duckdb::LogicalTypeId::STRUCT:
+      return nested_terms_to_vector(env, items, vector, count);
+    default:
+      return generic_terms_to_vector(env, items, vector, count);
+  }
+}
+
+bool nif::ColumnSource::init(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& type) {
+  unsigned length = 0;
+  if (enif_get_list_length(env, term, &length)) {
+    items = term;
+    rows = length;
+    return true;
+  }
+
+  if (!is_packable(type))
+    return false;
+
+  int arity = 0;
+  const ERL_NIF_TERM* tuple;
+  if (enif_get_tuple(env, term, &arity, &tuple)) {
+    if (arity != 2 || !enif_inspect_binary(env, tuple[0], &data))
+      return false;
+
+    if (tuple[1] == nif::atoms.nil)
+      validity.data = nullptr;
+    else if (!enif_inspect_binary(env, tuple[1], &validity))
+      return false;
+  } else if (enif_inspect_binary(env, term, &data)) {
+    validity.data = nullptr;
+  } else {
+    return false;
+  }
+
+  width = duckdb::GetTypeIdSize(type.InternalType());
+  if (data.size % width)
+    return false;
+
+  rows = data.size / width;
+  if (validity.data && validity.size < (rows + 7) / 8)
+    return false;
+
+  packed = true;
+  return true;
+}
+
+bool nif::ColumnSource::read(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count) {
+  if (!packed)
+    return terms_to_vector(env, items, vector, count);
+
+  auto sink = duckdb::FlatVector::GetData<uint8_t>(vector);
+  std::memcpy(sink, data.data + offset * width, count * width);
+
+  // any non zero byte is true
+  if (vector.GetType().id() == duckdb::LogicalTypeId::BOOLEAN) {
+    for (duckdb::idx_t row = 0; row < count; row++)
+      sink[row] = sink[row] ? 1 : 0;
+  }
+
+  if (validity.data) {
+    auto& mask = duckdb::FlatVector::Validity(vector);
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      size_t bit = offset + row;
+      if (!(validity.data[bit >> 3] & (1 << (bit & 7))))
+        mask.SetInvalid(row);
+    }
+  }
+
+  offset += count;
+  return true;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "duckdb.hpp"
+#include <erl_nif.h>
+
+namespace nif {
+  /*
+   * Writes the next `count` terms of the list into the rows [0, count) of the flat vector
+   * (`nil` is NULL), `items` is advanced to the tail of the list after the written terms.
+   * Numeric, boolean, string and nested (LIST, MAP, ARRAY, STRUCT) columns are written
+   * into the vector data directly, the other types go through duckdb::Value.
+   */
+  bool terms_to_vector(ErlNifEnv* env, ERL_NIF_TERM& items, duckdb::Vector& vector, duckdb::idx_t count);
+
+  /*
+   * The column given to the appender: the list of terms or, for the fixed-width types
+   * (see is_packable), the binary of the values in the DuckDB in-memory (native-endian)
+   * layout, optionally with the validity bitmap `{data, validity}` (LSB first, the bit
+   * is set for not NULL rows) as fetch_chunk_packed returns them.
+   * The values are read into the vectors chunk by chunk.
+   */
+  class ColumnSource {
+    public:
+      ColumnSource() : items(0), packed(false), rows(0), width(0), offset(0) {}
+
+      bool init(ErlNifEnv* env, ERL_NIF_TERM term, const duckdb::LogicalType& type);
+
+      size_t size() const { return rows; }
+
+      // Writes the next `count` values of the column into the flat vector
+      bool read(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count);
+
+    private:
+      ERL_NIF_TERM items;
+      bool packed;
+      ErlNifBinary data;
+      ErlNifBinary validity;
+      size_t rows;
+      size_t width;
+      size_t offset;
+  };
+}
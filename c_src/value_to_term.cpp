@@ -2,92 +2,153 @@
 #include "duckdb.hpp"
 #include "duckdb/common/types/time.hpp"
 #include "duckdb/common/types/uuid.hpp"
+#include "atoms.h"
 #include "term.h"
 #include <cmath>
 
 ERL_NIF_TERM nif::logical_type_to_term(ErlNifEnv* env, const duckdb::LogicalType& type) {
   switch (type.id()) {
     case duckdb::LogicalTypeId::BOOLEAN:
-      return make_atom(env, "boolean");
+      return nif::atoms.boolean;
     case duckdb::LogicalTypeId::CHAR:
     case duckdb::LogicalTypeId::VARCHAR:
     case duckdb::LogicalTypeId::ENUM:
-      return make_atom(env, "string");
+      return nif::atoms.string;
     case duckdb::LogicalTypeId::TINYINT:
-      return make_atom(env, "tinyint");
+      return nif::atoms.tinyint;
     case duckdb::LogicalTypeId::UTINYINT:
-      return make_atom(env, "utinyint");
+      return nif::atoms.utinyint;
     case duckdb::LogicalTypeId::SMALLINT:
-      return make_atom(env, "smallint");
+      return nif::atoms.smallint;
     case duckdb::LogicalTypeId::USMALLINT:
-      return make_atom(env, "usmallint");
+      return nif::atoms.usmallint;
     case duckdb::LogicalTypeId::INTEGER:
-      return make_atom(env, "integer");
+      return nif::atoms.integer;
     case duckdb::LogicalTypeId::UINTEGER:
-      return make_atom(env, "uinteger");
+      return nif::atoms.uinteger;
     case duckdb::LogicalTypeId::BIGINT:
-      return make_atom(env, "bigint");
+      return nif::atoms.bigint;
     case duckdb::LogicalTypeId::UBIGINT:
-      return make_atom(env, "ubigint");
+      return nif::atoms.ubigint;
     case duckdb::LogicalTypeId::HUGEINT:
-      return make_atom(env, "hugeint");
+      return nif::atoms.hugeint;
     case duckdb::LogicalTypeId::UHUGEINT:
-      return make_atom(env, "uhugeint");
+      return nif::atoms.uhugeint;
     case duckdb::LogicalTypeId::FLOAT:
-      return make_atom(env, "float");
+      return nif::atoms.float_;
     case duckdb::LogicalTypeId::DOUBLE:
-      return make_atom(env, "double");
+      return nif::atoms.double_;
     case duckdb::LogicalTypeId::DECIMAL:
-      return make_atom(env, "decimal");
+      return nif::atoms.decimal;
     case duckdb::LogicalTypeId::DATE:
-      return make_atom(env, "date");
+      return nif::atoms.date;
     case duckdb::LogicalTypeId::TIME:
-      return make_atom(env, "time");
+      return nif::atoms.time;
     case duckdb::LogicalTypeId::TIME_TZ:
-      return make_atom(env, "time_tz");
+      return nif::atoms.time_tz;
     case duckdb::LogicalTypeId::TIMESTAMP:
-      return make_atom(env, "timestamp");
+      return nif::atoms.timestamp;
     case duckdb::LogicalTypeId::TIMESTAMP_TZ:
-      return make_atom(env, "timestamp_tz");
+      return nif::atoms.timestamp_tz;
     case duckdb::LogicalTypeId::TIMESTAMP_NS:
-      return make_atom(env, "timestamp_ns");
+      return nif::atoms.timestamp_ns;
     case duckdb::LogicalTypeId::TIMESTAMP_MS:
-      return make_atom(env, "timestamp_ms");
+      return nif::atoms.timestamp_ms;
     case duckdb::LogicalTypeId::TIMESTAMP_SEC:
-      return make_atom(env, "timestamp_sec");
+      return nif::atoms.timestamp_sec;
     case duckdb::LogicalTypeId::INTERVAL:
-      return make_atom(env, "interval");
+      return nif::atoms.interval;
     case duckdb::LogicalTypeId::BLOB:
-      return make_atom(env, "blob");
+      return nif::atoms.blob;
     case duckdb::LogicalTypeId::UUID:
-      return make_atom(env, "uuid");
+      return nif::atoms.uuid;
     case duckdb::LogicalTypeId::LIST:
-      return make_atom(env, "list");
+      return nif::atoms.list;
     case duckdb::LogicalTypeId::ARRAY:
-      return make_atom(env, "array");
+      return nif::atoms.array;
     case duckdb::LogicalTypeId::MAP:
-      return make_atom(env, "map");
+      return nif::atoms.map;
     case duckdb::LogicalTypeId::STRUCT:
-      return make_atom(env, "struct");
+      return nif::atoms.struct_;
     case duckdb::LogicalTypeId::UNION:
-      return make_atom(env, "union");
+      return nif::atoms.union_;
     case duckdb::LogicalTypeId::ANY:
-      return make_atom(env, "any");
+      return nif::atoms.any;
     default:
-      return make_atom(env, "unknown");
+      return nif::atoms.unknown;
   }
 }
 
+ERL_NIF_TERM nif::boolean_to_term(ErlNifEnv* env, bool boolean) {
+  return boolean ? nif::atoms.true_ : nif::atoms.false_;
+}
+
+ERL_NIF_TERM nif::double_to_term(ErlNifEnv* env, double a_double) {
+  // Handle special floating-point cases
+  if (std::isinf(a_double))
+    return a_double > 0 ? nif::atoms.infinity : nif::atoms.neg_infinity;
+
+  if (std::isnan(a_double))
+    return nif::atoms.nan;
+
+  return enif_make_double(env, a_double);
+}
+
+ERL_NIF_TERM nif::hugeint_to_term(ErlNifEnv* env, duckdb::hugeint_t hugeint) {
+  return enif_make_tuple2(env,
+    enif_make_int64(env, hugeint.upper),
+    enif_make_uint64(env, hugeint.lower)
+  );
+}
+
+ERL_NIF_TERM nif::uhugeint_to_term(ErlNifEnv* env, duckdb::uhugeint_t uhugeint) {
+  return enif_make_tuple2(env,
+    enif_make_uint64(env, uhugeint.upper),
+    enif_make_uint64(env, uhugeint.lower)
+  );
+}
+
+ERL_NIF_TERM nif::uuid_to_term(ErlNifEnv* env, duckdb::hugeint_t uuid) {
+  char buff[duckdb::UUID::STRING_SIZE];
+  duckdb::UUID::ToString(uuid, buff);
+  return make_binary_term(env, buff, duckdb::UUID::STRING_SIZE);
+}
+
+ERL_NIF_TERM nif::date_to_term(ErlNifEnv* env, duckdb::date_t date) {
+  int32_t out_year, out_month, out_day;
+  duckdb::Date::Convert(date, out_year, out_month, out_day);
+  return enif_make_tuple3(env,
+    enif_make_int(env, out_year),
+    enif_make_int(env, out_month),
+    enif_make_int(env, out_day));
+}
+
+ERL_NIF_TERM nif::time_to_term(ErlNifEnv* env, duckdb::dtime_t time) {
+  int32_t time_units[4];
+  duckdb::Time::Convert(time, time_units[0], time_units[1], time_units[2], time_units[3]);
+  return enif_make_tuple4(env,
+    enif_make_int(env, time_units[0]),
+    enif_make_int(env, time_units[1]),
+    enif_make_int(env, time_units[2]),
+    enif_make_int(env, time_units[3]));
+}
+
+ERL_NIF_TERM nif::timestamp_to_term(ErlNifEnv* env, duckdb::timestamp_t timestamp) {
+  duckdb::date_t out_date = duckdb::Timestamp::GetDate(timestamp);
+  duckdb::dtime_t out_time = duckdb::Timestamp::GetTime(timestamp);
+  return enif_make_tuple2(env, date_to_term(env, out_date), time_to_term(env, out_time));
+}
+
 bool nif::value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM& sink) {
   // <dbg>
   // std::cout << "value_to_term: value_type: " << value.type().ToString() << std::endl;
   // std::cout << "value_to_term: value enum code: " << unsigned(static_cast<std::underlying_type<duckdb::LogicalTypeId>::type>(value.type().id())) << std::endl;
   // </dbg>
 
-  auto type = value.type();
+  const auto& type = value.type();
 
   if (value.IsNull()) {
-    sink = make_atom(env, "nil");
+    sink = nif::atoms.nil;
     return true;
   }
 
@@ -103,40 +164,20 @@ bool nif::value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM
         return true;
       }
     case duckdb::LogicalTypeId::BOOLEAN: {
-        bool boolean = duckdb::BooleanValue::Get(value);
-        sink = enif_make_atom(env, boolean ? "true" : "false");
+        sink = boolean_to_term(env, duckdb::BooleanValue::Get(value));
         return true;
       }
     case duckdb::LogicalTypeId::BLOB: {
-        auto blob = duckdb::StringValue::Get(value);
+        auto& blob = duckdb::StringValue::Get(value);
         sink = make_binary_term(env, blob);
         return true;
       }
     case duckdb::LogicalTypeId::DATE: {
-        auto date = value.GetValueUnsafe<duckdb::date_t>();
-        int32_t out_year, out_month, out_day;
-        duckdb::Date::Convert(date, out_year, out_month, out_day);
-        sink = enif_make_tuple3(env,
-          enif_make_int(env, out_year),
-          enif_make_int(env, out_month),
-          enif_make_int(env, out_day));
+        sink = date_to_term(env, value.GetValueUnsafe<duckdb::date_t>());
         return true;
       }
     case duckdb::LogicalTypeId::DOUBLE: {
-        auto a_double = value.GetValueUnsafe<double>();
-
-        // Handle special floating-point cases
-        if (std::isinf(a_double)) {
-            if (a_double > 0) {
-                sink = make_atom(env, "infinity"); // Positive infinity
-            } else {
-                sink = make_atom(env, "-infinity"); // Negative infinity
-            }
-        } else if (std::isnan(a_double)) {
-            sink = make_atom(env, "nan"); // Handle NaN
-        } else {
-            sink = enif_make_double(env, a_double); // Regular double handling
-        }
+        sink = double_to_term(env, value.GetValueUnsafe<double>());
         return true;
       }
     case duckdb::LogicalTypeId::DECIMAL: {
@@ -180,19 +221,11 @@ bool nif::value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM
         return false;
       }
     case duckdb::LogicalTypeId::HUGEINT: {
-        duckdb::hugeint_t hugeint = duckdb::HugeIntValue::Get(value);
-        sink = enif_make_tuple2(env,
-              enif_make_int64(env, hugeint.upper),
-              enif_make_uint64(env, hugeint.lower)
-            );
+        sink = hugeint_to_term(env, duckdb::HugeIntValue::Get(value));
         return true;
       }
     case duckdb::LogicalTypeId::UHUGEINT: {
-        duckdb::uhugeint_t uhugeint = duckdb::UhugeIntValue::Get(value);
-        sink = enif_make_tuple2(env,
-              enif_make_uint64(env, uhugeint.upper),
-              enif_make_uint64(env, uhugeint.lower)
-            );
+        sink = uhugeint_to_term(env, duckdb::UhugeIntValue::Get(value));
         return true;
       }
     case duckdb::LogicalTypeId::INTEGER: {
@@ -207,19 +240,7 @@ bool nif::value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM
       }
 
     case duckdb::LogicalTypeId::FLOAT: {
-        auto a_float = value.GetValueUnsafe<float>();
-
-        if (std::isinf(a_float)) {
-            if (a_float > 0) {
-                sink = make_atom(env, "infinity");
-            } else {
-                sink = make_atom(env, "-infinity");
-            }
-        } else if (std::isnan(a_float)) {
-            sink = make_atom(env, "nan");
-        } else {
-            sink = enif_make_double(env, a_float);
-        }
+        sink = double_to_term(env, value.GetValueUnsafe<float>());
         return true;
       }
     case duckdb::LogicalTypeId::SMALLINT: {
@@ -233,14 +254,7 @@ bool nif::value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM
         return true;
       }
     case duckdb::LogicalTypeId::TIME: {
-        duckdb::dtime_t time = duckdb::TimeValue::Get(value);
-        int32_t time_units[4];
-        duckdb::Time::Convert(time, time_units[0], time_units[1], time_units[2], time_units[3]);
-        sink = enif_make_tuple4(env,
-          enif_make_int(env, time_units[0]),
-          enif_make_int(env, time_units[1]),
-          enif_make_int(env, time_units[2]),
-          enif_make_int(env, time_units[3]));
+        sink = time_to_term(env, duckdb::TimeValue::Get(value));
         return true;
       }
     case duckdb::LogicalTypeId::TIME_TZ: {
@@ -266,29 +280,7 @@ bool nif::value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM
       }
     case duckdb::LogicalTypeId::TIMESTAMP:
     case duckdb::LogicalTypeId::TIMESTAMP_TZ: {
-        duckdb::timestamp_t timestamp = duckdb::TimestampValue::Get(value);
-
-        duckdb::date_t out_date = duckdb::Timestamp::GetDate(timestamp);
-        duckdb::dtime_t out_time = duckdb::Timestamp::GetTime(timestamp);
-
-        int32_t out_year, out_month, out_day;
-        duckdb::Date::Convert(out_date, out_year, out_month, out_day);
-
-        int32_t out_hour, out_min, out_sec, out_micros;
-        duckdb::Time::Convert(out_time, out_hour, out_min, out_sec, out_micros);
-
-        sink = enif_make_tuple2(env,
-          enif_make_tuple3(env,
-            enif_make_int(env, out_year),
-            enif_make_int(env, out_month),
-            enif_make_int(env, out_day)),
-          enif_make_tuple4(env,
-            enif_make_int(env, out_hour),
-            enif_make_int(env, out_min),
-            enif_make_int(env, out_sec),
-            enif_make_int(env, out_micros))
-        );
-
+        sink = timestamp_to_term(env, duckdb::TimestampValue::Get(value));
         return true;
       }
     case duckdb::LogicalTypeId::TIMESTAMP_NS: {
@@ -406,24 +398,20 @@ bool nif::value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM
         return true;
       }
     case duckdb::LogicalTypeId::UUID: {
-        duckdb::hugeint_t hugeint = duckdb::HugeIntValue::Get(value);
-
-        char buff[duckdb::UUID::STRING_SIZE];
-        duckdb::UUID::ToString(hugeint, buff);
-
-        sink = make_binary_term(env, buff, duckdb::UUID::STRING_SIZE);
-
+        sink = uuid_to_term(env, duckdb::HugeIntValue::Get(value));
         return true;
       }
     case duckdb::LogicalTypeId::CHAR:
     case duckdb::LogicalTypeId::VARCHAR: {
-        auto varchar = value.ToString();
-        sink = make_binary_term(env, varchar.c_str(), varchar.size());
+        auto& varchar = duckdb::StringValue::Get(value);
+        sink = make_binary_term(env, varchar);
         return true;
       }
     case duckdb::LogicalTypeId::ENUM: {
-        std::string enum_value = duckdb::EnumType::GetValue(value);
-        sink = make_binary_term(env, enum_value);
+        // the dictionary string, not the copy EnumType::GetValue returns
+        auto& dictionary = duckdb::EnumType::GetValuesInsertOrder(type);
+        auto enum_value = duckdb::FlatVector::GetData<duckdb::string_t>(dictionary)[value.GetValue<uint32_t>()];
+        sink = make_binary_term(env, enum_value.GetData(), enum_value.GetSize());
         return true;
       }
     case duckdb::LogicalTypeId::LIST: {
@@ -4,9 +4,23 @@
 namespace duckdb {
   class LogicalType;
   class Value;
+  struct date_t;
+  struct dtime_t;
+  struct timestamp_t;
+  struct hugeint_t;
+  struct uhugeint_t;
 }
 
 namespace nif {
   ERL_NIF_TERM logical_type_to_term(ErlNifEnv* env, const duckdb::LogicalType& type);
   bool value_to_term(ErlNifEnv* env, const duckdb::Value& value, ERL_NIF_TERM& sink);
+
+  ERL_NIF_TERM boolean_to_term(ErlNifEnv* env, bool boolean);
+  ERL_NIF_TERM double_to_term(ErlNifEnv* env, double a_double);
+  ERL_NIF_TERM hugeint_to_term(ErlNifEnv* env, duckdb::hugeint_t hugeint);
+  ERL_NIF_TERM uhugeint_to_term(ErlNifEnv* env, duckdb::uhugeint_t uhugeint);
+  ERL_NIF_TERM uuid_to_term(ErlNifEnv* env, duckdb::hugeint_t uuid);
+  ERL_NIF_TERM date_to_term(ErlNifEnv* env, duckdb::date_t date);
+  ERL_NIF_TERM time_to_term(ErlNifEnv* env, duckdb::dtime_t time);
+  ERL_NIF_TERM timestamp_to_term(ErlNifEnv* env, duckdb::timestamp_t timestamp);
 }
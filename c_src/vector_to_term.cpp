@@ -0,0 +1,434 @@
+#include "vector_to_term.h"
+#include "atoms.h"
+#include "term.h"
+#include "value_to_term.h"
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+  ERL_NIF_TERM int_to_term(ErlNifEnv* env, int32_t value) {
+    return enif_make_int(env, value);
+  }
+
+  ERL_NIF_TERM uint_to_term(ErlNifEnv* env, uint32_t value) {
+    return enif_make_uint(env, value);
+  }
+
+  ERL_NIF_TERM int64_to_term(ErlNifEnv* env, int64_t value) {
+    return enif_make_int64(env, value);
+  }
+
+  ERL_NIF_TERM uint64_to_term(ErlNifEnv* env, uint64_t value) {
+    return enif_make_uint64(env, value);
+  }
+
+  ERL_NIF_TERM string_to_term(ErlNifEnv* env, duckdb::string_t value) {
+    return nif::make_binary_term(env, value.GetData(), value.GetSize());
+  }
+
+  /*
+   * The loop specialized by the physical type of the vector (T) and the function
+   * building the term from the single value (CONVERT).
+   */
+  template <class T, class ARG, ERL_NIF_TERM (*CONVERT)(ErlNifEnv*, ARG)>
+  bool typed_vector_to_terms(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM* sink, duckdb::idx_t stride) {
+    ERL_NIF_TERM nil = nif::atoms.nil;
+
+    // The same term is shared by all the rows of the constant vector
+    if (vector.GetVectorType() == duckdb::VectorType::CONSTANT_VECTOR) {
+      ERL_NIF_TERM term = duckdb::ConstantVector::IsNull(vector)
+        ? nil
+        : CONVERT(env, *duckdb::ConstantVector::GetData<T>(vector));
+
+      for (duckdb::idx_t row = 0; row < count; row++)
+        sink[row * stride] = term;
+
+      return true;
+    }
+
+    duckdb::UnifiedVectorFormat format;
+    vector.ToUnifiedFormat(count, format);
+
+    auto data = duckdb::UnifiedVectorFormat::GetData<T>(format);
+
+    if (format.validity.AllValid()) {
+      for (duckdb::idx_t row = 0; row < count; row++)
+        sink[row * stride] = CONVERT(env, data[format.sel->get_index(row)]);
+    } else {
+      for (duckdb::idx_t row = 0; row < count; row++) {
+        auto idx = format.sel->get_index(row);
+        sink[row * stride] = format.validity.RowIsValid(idx) ? CONVERT(env, data[idx]) : nil;
+      }
+    }
+
+    return true;
+  }
+
+  /*
+   * Strings up to this size are copied into their own heap binaries (that is cheaper than
+   * a refc binary), the longer ones are packed into a single refc binary per vector and
+   * every such cell is returned as the sub binary of it.
+   */
+  const size_t HEAP_BINARY_LIMIT = 64;
+
+  bool string_vector_to_terms(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM* sink, duckdb::idx_t stride) {
+    if (vector.GetVectorType() == duckdb::VectorType::CONSTANT_VECTOR)
+      return typed_vector_to_terms<duckdb::string_t, duckdb::string_t, string_to_term>(env, vector, count, sink, stride);
+
+    duckdb::UnifiedVectorFormat format;
+    vector.ToUnifiedFormat(count, format);
+
+    auto data = duckdb::UnifiedVectorFormat::GetData<duckdb::string_t>(format);
+
+    size_t packed_size = 0;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      auto idx = format.sel->get_index(row);
+      if (format.validity.RowIsValid(idx) && data[idx].GetSize() > HEAP_BINARY_LIMIT)
+        packed_size += data[idx].GetSize();
+    }
+
+    ERL_NIF_TERM packed_term;
+    if (packed_size) {
+      ErlNifBinary packed;
+      if (!enif_alloc_binary(packed_size, &packed))
+        return false;
+
+      size_t offset = 0;
+      for (duckdb::idx_t row = 0; row < count; row++) {
+        auto idx = format.sel->get_index(row);
+        if (format.validity.RowIsValid(idx) && data[idx].GetSize() > HEAP_BINARY_LIMIT) {
+          std::memcpy(packed.data + offset, data[idx].GetData(), data[idx].GetSize());
+          offset += data[idx].GetSize();
+        }
+      }
+
+      // the ownership of the binary goes to the term
+      packed_term = enif_make_binary(env, &packed);
+    }
+
+    ERL_NIF_TERM nil = nif::atoms.nil;
+    size_t offset = 0;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      auto idx = format.sel->get_index(row);
+      if (!format.validity.RowIsValid(idx)) {
+        sink[row * stride] = nil;
+      } else if (data[idx].GetSize() > HEAP_BINARY_LIMIT) {
+        sink[row * stride] = enif_make_sub_binary(env, packed_term, offset, data[idx].GetSize());
+        offset += data[idx].GetSize();
+      } else {
+        sink[row * stride] = string_to_term(env, data[idx]);
+      }
+    }
+
+    return true;
+  }
+
+  /*
+   * ENUM vector holds the indexes (T) of the type dictionary strings, the binary
+   * of every dictionary string is made once per vector and shared by its rows.
+   * The terms are cached by the index in the table when the dictionary is not larger
+   * than the vector, otherwise in the map of the indexes met in the vector only.
+   */
+  template <class T>
+  bool enum_vector_to_terms(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM* sink, duckdb::idx_t stride) {
+    auto& dictionary = duckdb::EnumType::GetValuesInsertOrder(vector.GetType());
+    auto strings = duckdb::FlatVector::GetData<duckdb::string_t>(dictionary);
+
+    duckdb::UnifiedVectorFormat format;
+    vector.ToUnifiedFormat(count, format);
+
+    auto data = duckdb::UnifiedVectorFormat::GetData<T>(format);
+
+    // 0 is not a valid term, the string of the index is not converted yet
+    duckdb::idx_t size = duckdb::EnumType::GetSize(vector.GetType());
+    std::vector<ERL_NIF_TERM> table(size <= count ? size : 0, 0);
+    std::unordered_map<T, ERL_NIF_TERM> map;
+    ERL_NIF_TERM nil = nif::atoms.nil;
+
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      auto idx = format.sel->get_index(row);
+      if (!format.validity.RowIsValid(idx)) {
+        sink[row * stride] = nil;
+        continue;
+      }
+
+      ERL_NIF_TERM& term = table.empty() ? map[data[idx]] : table[data[idx]];
+      if (!term)
+        term = string_to_term(env, strings[data[idx]]);
+
+      sink[row * stride] = term;
+    }
+
+    return true;
+  }
+
+  /*
+   * Fallback for the types without the specialized loop: goes through duckdb::Value
+   */
+  bool generic_vector_to_terms(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM* sink, duckdb::idx_t stride) {
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      auto value = vector.GetValue(row);
+      if (!nif::value_to_term(env, value, sink[row * stride]))
+        return false;
+    }
+
+    return true;
+  }
+
+  /*
+   * LIST and ARRAY of the fixed-width type: {{list | array, child_type}, rows, validity}.
+   * The elements of every row are returned as the binary (the sub binary of the single binary
+   * of the column), nil for NULL rows. The validity is nil if no element is NULL, otherwise
+   * the list of the element bitmaps of the rows (nil for the rows without NULL elements),
+   * the values of NULL elements are undefined.
+   */
+  bool packed_list_vector_to_term(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM& sink) {
+    auto& type = vector.GetType();
+    bool is_array = type.id() == duckdb::LogicalTypeId::ARRAY;
+
+    duckdb::Vector& child = is_array ? duckdb::ArrayVector::GetEntry(vector) : duckdb::ListVector::GetEntry(vector);
+    duckdb::idx_t array_size = is_array ? duckdb::ArrayType::GetSize(type) : 0;
+    duckdb::idx_t child_size = is_array ? duckdb::ArrayVector::GetTotalSize(vector) : duckdb::ListVector::GetListSize(vector);
+    duckdb::idx_t width = duckdb::GetTypeIdSize(child.GetType().InternalType());
+
+    duckdb::UnifiedVectorFormat format;
+    vector.ToUnifiedFormat(count, format);
+
+    duckdb::UnifiedVectorFormat child_format;
+    child.ToUnifiedFormat(child_size, child_format);
+
+    // the range of the child elements of the row
+    std::vector<std::pair<duckdb::idx_t, duckdb::idx_t>> ranges(count);
+    size_t packed_size = 0;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      auto idx = format.sel->get_index(row);
+      if (!format.validity.RowIsValid(idx))
+        continue;
+
+      if (is_array) {
+        ranges[row] = std::make_pair(idx * array_size, array_size);
+      } else {
+        auto& entry = duckdb::UnifiedVectorFormat::GetData<duckdb::list_entry_t>(format)[idx];
+        ranges[row] = std::make_pair(entry.offset, entry.length);
+      }
+
+      packed_size += ranges[row].second * width;
+    }
+
+    ErlNifBinary packed;
+    if (!enif_alloc_binary(packed_size, &packed))
+      return false;
+
+    bool is_flat = child.GetVectorType() == duckdb::VectorType::FLAT_VECTOR;
+    size_t offset = 0;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      auto& range = ranges[row];
+      if (is_flat) {
+        std::memcpy(packed.data + offset, child_format.data + range.first * width, range.second * width);
+      } else {
+        for (duckdb::idx_t element = 0; element < range.second; element++)
+          std::memcpy(packed.data + offset + element * width, child_format.data + child_format.sel->get_index(range.first + element) * width, width);
+      }
+      offset += range.second * width;
+    }
+
+    // the ownership of the binary goes to the term
+    ERL_NIF_TERM packed_term = enif_make_binary(env, &packed);
+    ERL_NIF_TERM nil = nif::atoms.nil;
+
+    std::vector<ERL_NIF_TERM> rows(count, nil);
+    std::vector<ERL_NIF_TERM> validity;
+    if (!child_format.validity.AllValid())
+      validity.assign(count, nil);
+
+    bool has_nulls = false;
+    offset = 0;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      if (!format.validity.RowIsValid(format.sel->get_index(row)))
+        continue;
+
+      auto& range = ranges[row];
+      rows[row] = enif_make_sub_binary(env, packed_term, offset, range.second * width);
+      offset += range.second * width;
+
+      if (validity.empty())
+        continue;
+
+      bool row_has_nulls = false;
+      for (duckdb::idx_t element = 0; element < range.second && !row_has_nulls; element++)
+        row_has_nulls = !child_format.validity.RowIsValid(child_format.sel->get_index(range.first + element));
+
+      if (!row_has_nulls)
+        continue;
+
+      unsigned char* bits = enif_make_new_binary(env, (range.second + 7) / 8, &validity[row]);
+      std::memset(bits, 0, (range.second + 7) / 8);
+      for (duckdb::idx_t element = 0; element < range.second; element++) {
+        if (child_format.validity.RowIsValid(child_format.sel->get_index(range.first + element)))
+          bits[element >> 3] |= (unsigned char)(1 << (element & 7));
+      }
+
+      has_nulls = true;
+    }
+
+    ERL_NIF_TERM type_term = enif_make_tuple2(env,
+      nif::logical_type_to_term(env, type),
+      nif::logical_type_to_term(env, child.GetType()));
+
+    sink = enif_make_tuple3(env,
+      type_term,
+      enif_make_list_from_array(env, rows.data(), rows.size()),
+      has_nulls ? enif_make_list_from_array(env, validity.data(), validity.size()) : nil);
+
+    return true;
+  }
+
+  bool is_packable_list(const duckdb::LogicalType& type) {
+    switch (type.id()) {
+      case duckdb::LogicalTypeId::LIST:
+        return nif::is_packable(duckdb::ListType::GetChildType(type));
+      case duckdb::LogicalTypeId::ARRAY:
+        return nif::is_packable(duckdb::ArrayType::GetChildType(type));
+      default:
+        return false;
+    }
+  }
+
+  ERL_NIF_TERM make_validity_term(ErlNifEnv* env, const duckdb::UnifiedVectorFormat& format, duckdb::idx_t count) {
+    if (format.validity.AllValid())
+      return nif::atoms.nil;
+
+    ERL_NIF_TERM validity;
+    unsigned char* bits = enif_make_new_binary(env, (count + 7) / 8, &validity);
+    std::memset(bits, 0, (count + 7) / 8);
+
+    bool has_nulls = false;
+    for (duckdb::idx_t row = 0; row < count; row++) {
+      if (format.validity.RowIsValid(format.sel->get_index(row)))
+        bits[row >> 3] |= (unsigned char)(1 << (row & 7));
+      else
+        has_nulls = true;
+    }
+
+    return has_nulls ? validity : nif::atoms.nil;
+  }
+}
+
+bool nif::is_packable(const duckdb::LogicalType& type) {
+  switch (type.id()) {
+    case duckdb::LogicalTypeId::BOOLEAN:
+    case duckdb::LogicalTypeId::TINYINT:
+    case duckdb::LogicalTypeId::SMALLINT:
+    case duckdb::LogicalTypeId::INTEGER:
+    case duckdb::LogicalTypeId::BIGINT:
+    case duckdb::LogicalTypeId::UTINYINT:
+    case duckdb::LogicalTypeId::USMALLINT:
+    case duckdb::LogicalTypeId::UINTEGER:
+    case duckdb::LogicalTypeId::UBIGINT:
+    case duckdb::LogicalTypeId::FLOAT:
+    case duckdb::LogicalTypeId::DOUBLE:
+    case duckdb::LogicalTypeId::DATE:
+    case duckdb::LogicalTypeId::TIME:
+    case duckdb::LogicalTypeId::TIMESTAMP:
+    case duckdb::LogicalTypeId::TIMESTAMP_TZ:
+    case duckdb::LogicalTypeId::TIMESTAMP_NS:
+    case duckdb::LogicalTypeId::TIMESTAMP_MS:
+    case duckdb::LogicalTypeId::TIMESTAMP_SEC:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool nif::vector_to_terms(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM* sink, duckdb::idx_t stride) {
+  switch (vector.GetType().id()) {
+    case duckdb::LogicalTypeId::BOOLEAN:
+      return typed_vector_to_terms<bool, bool, boolean_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::TINYINT:
+      return typed_vector_to_terms<int8_t, int32_t, int_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::SMALLINT:
+      return typed_vector_to_terms<int16_t, int32_t, int_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::INTEGER:
+      return typed_vector_to_terms<int32_t, int32_t, int_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::BIGINT:
+      return typed_vector_to_terms<int64_t, int64_t, int64_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::UTINYINT:
+      return typed_vector_to_terms<uint8_t, uint32_t, uint_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::USMALLINT:
+      return typed_vector_to_terms<uint16_t, uint32_t, uint_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::UINTEGER:
+      return typed_vector_to_terms<uint32_t, uint32_t, uint_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::UBIGINT:
+      return typed_vector_to_terms<uint64_t, uint64_t, uint64_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::HUGEINT:
+      return typed_vector_to_terms<duckdb::hugeint_t, duckdb::hugeint_t, hugeint_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::UHUGEINT:
+      return typed_vector_to_terms<duckdb::uhugeint_t, duckdb::uhugeint_t, uhugeint_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::UUID:
+      return typed_vector_to_terms<duckdb::hugeint_t, duckdb::hugeint_t, uuid_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::FLOAT:
+      return typed_vector_to_terms<float, double, double_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::DOUBLE:
+      return typed_vector_to_terms<double, double, double_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::DATE:
+      return typed_vector_to_terms<duckdb::date_t, duckdb::date_t, date_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::TIME:
+      return typed_vector_to_terms<duckdb::dtime_t, duckdb::dtime_t, time_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::TIMESTAMP:
+    case duckdb::LogicalTypeId::TIMESTAMP_TZ:
+      return typed_vector_to_terms<duckdb::timestamp_t, duckdb::timestamp_t, timestamp_to_term>(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::CHAR:
+    case duckdb::LogicalTypeId::VARCHAR:
+    case duckdb::LogicalTypeId::BLOB:
+      return string_vector_to_terms(env, vector, count, sink, stride);
+    case duckdb::LogicalTypeId::ENUM:
+      switch (vector.GetType().InternalType()) {
+        case duckdb::PhysicalType::UINT8:
+          return enum_vector_to_terms<uint8_t>(env, vector, count, sink, stride);
+        case duckdb::PhysicalType::UINT16:
+          return enum_vector_to_terms<uint16_t>(env, vector, count, sink, stride);
+        case duckdb::PhysicalType::UINT32:
+          return enum_vector_to_terms<uint32_t>(env, vector, count, sink, stride);
+        default:
+          return generic_vector_to_terms(env, vector, count, sink, stride);
+      }
+    default:
+      return generic_vector_to_terms(env, vector, count, sink, stride);
+  }
+}
+
+bool nif::vector_to_packed_term(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM& sink) {
+  if (is_packable_list(vector.GetType()))
+    return packed_list_vector_to_term(env, vector, count, sink);
+
+  if (!is_packable(vector.GetType())) {
+    std::vector<ERL_NIF_TERM> terms(count);
+    if (!vector_to_terms(env, vector, count, terms.data(), 1))
+      return false;
+
+    sink = enif_make_list_from_array(env, terms.data(), terms.size());
+    return true;
+  }
+
+  duckdb::idx_t width = duckdb::GetTypeIdSize(vector.GetType().InternalType());
+
+  duckdb::UnifiedVectorFormat format;
+  vector.ToUnifiedFormat(count, format);
+
+  ERL_NIF_TERM data;
+  unsigned char* bytes = enif_make_new_binary(env, count * width, &data);
+
+  if (vector.GetVectorType() == duckdb::VectorType::FLAT_VECTOR) {
+    std::memcpy(bytes, format.data, count * width);
+  } else {
+    for (duckdb::idx_t row = 0; row < count; row++)
+      std::memcpy(bytes + row * width, format.data + format.sel->get_index(row) * width, width);
+  }
+
+  sink = enif_make_tuple3(env,
+    logical_type_to_term(env, vector.GetType()),
+    data,
+    make_validity_term(env, format, count));
+
+  return true;
+}
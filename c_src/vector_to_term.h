@@ -0,0 +1,28 @@
+#pragma once
+#include "duckdb.hpp"
+#include <erl_nif.h>
+
+namespace nif {
+  /*
+   * Converts the first `count` rows of the vector into terms reading the vector
+   * data directly (flat, constant and dictionary vectors are all supported).
+   * The term of the row `i` is written into `sink[i * stride]`, so a column can be
+   * converted straight into a row-major buffer of the chunk cells.
+   */
+  bool vector_to_terms(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM* sink, duckdb::idx_t stride);
+
+  /*
+   * Converts the fixed-width vector (numeric, temporal or boolean) into the
+   * `{type, data, validity}` tuple. `data` is the binary of `count` values in
+   * the DuckDB in-memory (native-endian) layout, `validity` is the bitmap
+   * (LSB first, the bit is set for not NULL rows) or `nil` when there are no NULLs.
+   * LIST and ARRAY vectors of such types are converted into the `{{list | array, type},
+   * rows, validity}` tuple: the list of binaries of the row elements (nil for NULL rows)
+   * and nil or the list of the element bitmaps of the rows.
+   * The other vectors are converted into the list of terms.
+   */
+  bool vector_to_packed_term(ErlNifEnv* env, duckdb::Vector& vector, duckdb::idx_t count, ERL_NIF_TERM& sink);
+
+  // The fixed-width types having the packed representation
+  bool is_packable(const duckdb::LogicalType& type);
+}
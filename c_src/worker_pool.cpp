@@ -0,0 +1,56 @@
+#include "worker_pool.h"
+
+void nif::WorkerPool::start(size_t threads_count) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!stopped)
+    return;
+
+  stopped = false;
+  for (size_t i = 0; i < threads_count; i++)
+    threads.emplace_back(&WorkerPool::run, this);
+}
+
+void nif::WorkerPool::stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopped = true;
+  }
+
+  condition.notify_all();
+
+  for (auto& thread : threads)
+    thread.join();
+
+  threads.clear();
+}
+
+bool nif::WorkerPool::submit(Job job) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopped)
+      return false;
+
+    jobs.push_back(std::move(job));
+  }
+
+  condition.notify_one();
+  return true;
+}
+
+void nif::WorkerPool::run() {
+  for (;;) {
+    Job job;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      condition.wait(lock, [this] { return stopped || !jobs.empty(); });
+
+      if (jobs.empty())
+        return;
+
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+
+    job();
+  }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nif {
+  /*
+   * Threads owned by the NIF running the async jobs in the FIFO order,
+   * so the long queries do not occupy the dirty schedulers.
+   */
+  class WorkerPool {
+    public:
+      typedef std::function<void()> Job;
+
+      WorkerPool() : stopped(true) {}
+      ~WorkerPool() { stop(); }
+
+      WorkerPool(const WorkerPool&) = delete;
+      WorkerPool& operator=(const WorkerPool&) = delete;
+
+      void start(size_t threads_count);
+
+      // Runs the already queued jobs and joins the threads
+      void stop();
+
+      // Returns false if the pool is not started
+      bool submit(Job job);
+
+      size_t size() const { return threads.size(); }
+
+    private:
+      void run();
+
+      std::mutex mutex;
+      std::condition_variable condition;
+      std::deque<Job> jobs;
+      std::vector<std::thread> threads;
+      bool stopped;
+  };
+}
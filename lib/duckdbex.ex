@@ -10,19 +10,28 @@ defmodule Duckdbex do
   @type statement() :: reference()
   @type query_result() :: reference()
   @type appender :: reference()
+  @type async_appender :: reference()
+  @type connection_pool() :: reference()
 
   @doc """
   Creates a DuckDB config object.
 
   The config can be reused across `open/2` calls and configured through `set_config_option/3`.
 
+  ## Options
+
+    * `:allocator` - `:erlang` makes the databases opened with the config allocate their memory
+      with `enif_alloc`, so it is seen by `:erlang.memory/0`, and count it (see `allocator_stats/1`).
+      Defaults to `:default`, the DuckDB allocator.
+
   ## Examples
 
     iex> {:ok, _config} = Duckdbex.create_config()
+    iex> {:ok, _config} = Duckdbex.create_config(allocator: :erlang)
   """
-  @spec create_config() :: {:ok, config()} | {:error, reason()}
-  def create_config(),
-    do: Duckdbex.NIF.create_config()
+  @spec create_config(keyword()) :: {:ok, config()} | {:error, reason()}
+  def create_config(opts \\ []) when is_list(opts),
+    do: Duckdbex.NIF.create_config(opts)
 
   @doc """
   Sets a DuckDB config option by name.
@@ -51,7 +60,7 @@ defmodule Duckdbex do
     do: Duckdbex.NIF.get_config_options()
 
   @doc """
-  Release resource (config, db, connection, stmt, query_result)
+  Release resource (config, db, connection, connection_pool, stmt, query_result)
 
   Will cause destruction and automatic closing the releasing resource in the calling process on dirty schedulers. The released resource cannot be used after this point.
 
@@ -66,7 +75,7 @@ defmodule Duckdbex do
     iex> :ok = Duckdbex.release(conn)
     iex> :ok = Duckdbex.release(db)
   """
-  @spec release(config() | db() | connection() | statement() | query_result() | appender()) :: :ok
+  @spec release(config() | db() | connection() | connection_pool() | statement() | query_result() | appender()) :: :ok
   def release(resource) when is_reference(resource),
     do: Duckdbex.NIF.release(resource)
 
@@ -105,6 +114,47 @@ defmodule Duckdbex do
   def open(config) when is_reference(config),
     do: Duckdbex.NIF.open(":memory:", config)
 
+  @doc """
+  Returns the memory counters of the database opened with the `allocator: :erlang` config
+  (see `create_config/1`) or `nil` if the database uses the DuckDB allocator.
+
+  `live_bytes` is the memory allocated by the database now, `peak_bytes` is its maximum
+  and `allocations` is the number of the allocations made.
+
+  ## Examples
+
+    iex> {:ok, config} = Duckdbex.create_config(allocator: :erlang)
+    iex> {:ok, db} = Duckdbex.open(config)
+    iex> %{live_bytes: _, peak_bytes: _, allocations: _} = Duckdbex.allocator_stats(db)
+  """
+  @spec allocator_stats(db()) :: %{live_bytes: non_neg_integer(), peak_bytes: non_neg_integer(), allocations: non_neg_integer()} | nil
+  def allocator_stats(db) when is_reference(db),
+    do: Duckdbex.NIF.allocator_stats(db)
+
+  @doc """
+  Sets the process receiving the timings of the NIF calls, `nil` removes it (the default).
+
+  Every query, execute_statement, execute_many, fetch and appender call sends
+  `{:duckdbex_telemetry, event, measurements}` to the collector, where `event` is the call
+  (`:query`, `:execute_statement`, `:execute_many`, `:fetch_chunk`, `:fetch_all`, `:fetch_chunk_columns`,
+  `:fetch_all_columns`, `:fetch_chunk_packed`, `:appender_add_row`, `:appender_add_rows`,
+  `:appender_add_columns`, `:appender_flush`, `:appender_close`) and `measurements` is a map of
+  `:total` (the time of the call in the NIF), `:rows` and `:bytes` (the memory of the fetched or appended
+  chunks) and the time of the phases the call went through: `:queue` (the wait of the async call for
+  a worker), `:prepare`, `:bind`, `:execute`, `:fetch`, `:convert`, `:append` and `:flush`.
+  The times are in nanoseconds of the monotonic clock. The collector can forward them as
+  `:telemetry.execute([:duckdbex, event], measurements)` events.
+
+  Without the collector the calls do not read the clock.
+
+  ## Examples
+
+    iex> :ok = Duckdbex.set_telemetry_collector(nil)
+  """
+  @spec set_telemetry_collector(pid() | nil) :: :ok
+  def set_telemetry_collector(pid) when is_pid(pid) or is_nil(pid),
+    do: Duckdbex.NIF.set_telemetry_collector(pid)
+
   @doc """
   Opens database in the memory.
 
@@ -130,6 +180,97 @@ defmodule Duckdbex do
   def connection(db) when is_reference(db),
     do: Duckdbex.NIF.connection(db)
 
+  @doc """
+  Creates connection object with options, see `connection/1`.
+
+  ## Options
+
+    * `:statement_cache_size` - how many prepared statements of `query/3` (and `query/4` with arguments)
+      the connection keeps, the least recently used ones are dropped. `0` disables the cache. Defaults to `64`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, _conn} = Duckdbex.connection(db, statement_cache_size: 128)
+  """
+  @spec connection(db(), keyword()) :: {:ok, connection()} | {:error, reason()}
+  def connection(db, opts) when is_reference(db) and is_list(opts),
+    do: Duckdbex.NIF.connection(db, opts)
+
+  @doc """
+  Returns the counters of the connection prepared statement cache.
+
+  The query with parameters is prepared once and taken from the cache by the SQL text afterwards.
+  DuckDB rebinds the cached statement by itself if the tables it depends on are changed,
+  the statement that failed to execute is removed from the cache.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, _res} = Duckdbex.query(conn, "SELECT 1 WHERE $1 = 1;", [1])
+    iex> {:ok, _res} = Duckdbex.query(conn, "SELECT 1 WHERE $1 = 1;", [2])
+    iex> %{size: 1, capacity: 64, hits: 1, misses: 1} = Duckdbex.statement_cache_stats(conn)
+  """
+  @spec statement_cache_stats(connection()) :: %{
+          size: non_neg_integer(),
+          capacity: non_neg_integer(),
+          hits: non_neg_integer(),
+          misses: non_neg_integer()
+        }
+  def statement_cache_stats(connection) when is_reference(connection),
+    do: Duckdbex.NIF.statement_cache_stats(connection)
+
+  @doc """
+  Drops all the prepared statements cached by the connection.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> :ok = Duckdbex.clear_statement_cache(conn)
+  """
+  @spec clear_statement_cache(connection()) :: :ok
+  def clear_statement_cache(connection) when is_reference(connection),
+    do: Duckdbex.NIF.clear_statement_cache(connection)
+
+  @doc """
+  Creates the pool of `size` connections to the database.
+
+  The queries issued with `pool_query/4` run on an idle connection of the pool, so the processes
+  sharing the pool do not wait for each other on the same connection and no checkout is needed.
+  The calling scheduler thread prefers the same connection every time.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, _pool} = Duckdbex.connection_pool(db, 4)
+  """
+  @spec connection_pool(db(), pos_integer()) :: {:ok, connection_pool()} | {:error, reason()}
+  def connection_pool(db, size) when is_reference(db) and is_integer(size) and size > 0,
+    do: Duckdbex.NIF.connection_pool(db, size)
+
+  @doc """
+  Issues a query on an idle connection of the pool, see `query/4`.
+
+  The connection goes back to the pool as soon as the query is done, so the result is always
+  materialized and the `:stream` option is not supported. The transaction left open by the query
+  is rolled back when the connection goes back to the pool. The other session state (`SET` options,
+  temporary tables, ...) stays on the connection and is seen by the later queries that happen to
+  run on it, so do not change it with `pool_query/4`, use a dedicated `connection/1` for that.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, pool} = Duckdbex.connection_pool(db, 4)
+    iex> {:ok, res} = Duckdbex.pool_query(pool, "SELECT 1 WHERE $1 = 1;", [1])
+    iex> [[1]] = Duckdbex.fetch_all(res)
+  """
+  @spec pool_query(connection_pool(), binary(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def pool_query(pool, sql_string, args \\ [], opts \\ [])
+      when is_reference(pool) and is_binary(sql_string) and is_list(args) and is_list(opts),
+      do: Duckdbex.NIF.pool_query(pool, sql_string, args, opts)
+
   @doc """
   Issues a query to the database and returns a result reference.
 
@@ -157,6 +298,59 @@ defmodule Duckdbex do
       when is_reference(connection) and is_binary(sql_string) and is_list(args),
       do: Duckdbex.NIF.query(connection, sql_string, args)
 
+  @doc """
+  Issues a query to the database with parameters and options and returns a result reference.
+
+  If `args` is an empty list the query is not prepared, so the sql may contain multiple statements.
+
+  ## Options
+
+    * `:stream` - if `true` the result is not materialized, every fetch pulls the next chunks
+      from the running query, so the memory is bounded and the first rows come earlier.
+      The streaming result becomes invalid as soon as the next query is issued on the same
+      connection. Defaults to `false`.
+
+    * `:cooperative` - if `true` the query is planned on the dirty scheduler and then run task by
+      task on the normal scheduler yielding as soon as its timeslice is consumed, so the execution
+      of the short queries does not hold the dirty scheduler. If a single task takes too long, or
+      the query keeps waiting for the DuckDB threads, the rest of the query goes to the dirty
+      scheduler, as does the query finding another query running on the connection. Do not issue
+      other queries on the connection while the cooperative query is running, the new query
+      closes the pending one, which then returns the error. Defaults to `false`.
+
+    * `:timeout` - the query running longer than that (in milliseconds) is interrupted and
+      `{:error, :timeout}` is returned. Only the execution of the query is limited, not fetching
+      of the streaming result. Not supported together with `:cooperative`. Defaults to `:infinity`.
+
+    * `:release_on_exit` - if `true` the result is released as soon as the calling process exits
+      (unless another process is fetching it at the moment), not when the garbage collector finds it.
+      Do not use it if the result is passed to another process to outlive the caller.
+      Not supported together with `:cooperative`. Defaults to `false`.
+
+    * `:profile` - if `true` the profiler is enabled for the query and its operator tree is taken with
+      the result, `profiling_tree/1` of the result returns it. The queries on the connection take turns, the queries of other
+      processes run after it and are not profiled unless `enable_profiling/1` is in effect. The tree
+      of the streaming result is not complete till the result is fetched, enable the profiling on
+      the connection with `enable_profiling/1` for it. Not supported together with `:cooperative`.
+      Defaults to `false`.
+
+  If the calling process exits while the query is running the query is interrupted.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM range(3);", [], stream: true)
+    iex> [[0], [1], [2]] = Duckdbex.fetch_all(res)
+  """
+  @spec query(connection(), binary(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def query(connection, sql_string, args, opts)
+      when is_reference(connection) and is_binary(sql_string) and is_list(args) and is_list(opts) do
+    if Keyword.get(opts, :cooperative, false),
+      do: Duckdbex.NIF.query_cooperative(connection, sql_string, args, opts),
+      else: Duckdbex.NIF.query(connection, sql_string, args, opts)
+  end
+
   @doc """
   Prepare the specified query, returning a reference to the prepared statement object
 
@@ -201,6 +395,72 @@ defmodule Duckdbex do
   def execute_statement(statement, args) when is_reference(statement) and is_list(args),
     do: Duckdbex.NIF.execute_statement(statement, args)
 
+  @doc """
+  Execute the prepared statement with the given list of parameters and options
+
+  Takes the same options as `query/4`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT * FROM range($1);")
+    iex> {:ok, res} = Duckdbex.execute_statement(stmt, [2], stream: true)
+    iex> [[0], [1]] = Duckdbex.fetch_all(res)
+  """
+  @spec execute_statement(statement(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def execute_statement(statement, args, opts)
+      when is_reference(statement) and is_list(args) and is_list(opts) do
+    if Keyword.get(opts, :cooperative, false),
+      do: Duckdbex.NIF.execute_statement_cooperative(statement, args, opts),
+      else: Duckdbex.NIF.execute_statement(statement, args, opts)
+  end
+
+  @doc """
+  Executes the prepared statement for every row of parameters in one call.
+
+  Returns the total number of the rows changed by the statement. Stops at the first failing
+  row and returns `{:error, {row_index, reason}}`, the index is zero based.
+
+  Options:
+    * `:transaction` - when `true` all the rows are executed in one transaction, which is rolled
+      back if any row fails. If the connection is already in a transaction the rows are executed in it.
+    * `:timeout` - interrupts the batch running longer than that (milliseconds), see `query/4`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, _res} = Duckdbex.query(conn, "CREATE TABLE many(i INTEGER, s VARCHAR);")
+    iex> {:ok, stmt} = Duckdbex.prepare_statement(conn, "INSERT INTO many VALUES ($1, $2);")
+    iex> {:ok, 2} = Duckdbex.execute_many(stmt, [[1, "one"], [2, "two"]], transaction: true)
+    iex> {:error, {1, "invalid type of parameter #1"}} = Duckdbex.execute_many(stmt, [[3, "three"], ["four", "four"]], transaction: true)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT count(*) FROM many;")
+    iex> [[2]] = Duckdbex.fetch_all(res)
+  """
+  @spec execute_many(statement(), [list()], keyword()) ::
+          {:ok, integer()} | {:error, {non_neg_integer(), reason()}} | {:error, reason()}
+  def execute_many(statement, rows, opts \\ [])
+      when is_reference(statement) and is_list(rows) and is_list(opts),
+      do: Duckdbex.NIF.execute_statement_many(statement, rows, opts)
+
+  @doc """
+  Interrupts the query running on the connection (or on the connection of the prepared statement).
+
+  The interrupted query returns `{:error, :cancelled}`. The streaming result runs the query
+  while it is fetched, the fetch of the interrupted one returns `{:error, :cancelled}` and
+  the fetch of the failed one returns `{:error, reason}`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> :ok = Duckdbex.cancel(conn)
+  """
+  @spec cancel(connection() | statement()) :: :ok
+  def cancel(connection_or_statement) when is_reference(connection_or_statement),
+    do: Duckdbex.NIF.cancel(connection_or_statement)
+
   @doc """
   Begin a transaction
 
@@ -282,6 +542,61 @@ defmodule Duckdbex do
   def has_active_transaction(connection) when is_reference(connection),
     do: Duckdbex.NIF.has_active_transaction(connection)
 
+  @doc """
+  Enables the profiler of the connection, every query issued on it is profiled
+  and its operator tree can be taken by `profiling_tree/1`. The enables are counted,
+  the profiler stays enabled till every one of them is disabled by `disable_profiling/1`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> :ok = Duckdbex.enable_profiling(conn)
+  """
+  @spec enable_profiling(connection()) :: :ok
+  def enable_profiling(connection) when is_reference(connection),
+    do: Duckdbex.NIF.enable_profiling(connection)
+
+  @doc """
+  Disables the profiler enabled by `enable_profiling/1`, the profiler of the connection is
+  turned off when the last enable is disabled. The tree of the last profiled query is kept.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> :ok = Duckdbex.disable_profiling(conn)
+  """
+  @spec disable_profiling(connection()) :: :ok
+  def disable_profiling(connection) when is_reference(connection),
+    do: Duckdbex.NIF.disable_profiling(connection)
+
+  @doc """
+  Returns the operator tree of the query result run with `profile: true`, or of the last profiled
+  query on the connection (or on the connection of the prepared statement) as nested maps, `nil`
+  if the query was not profiled. The tree of the connection is the one of whatever query was
+  profiled on it last, take the tree of the result to get the one of your query.
+
+  Every node holds the metrics DuckDB collects for it by their lowercased names, e.g.
+  `:operator_type`, `:operator_timing` (seconds), `:operator_cardinality`, `:operator_rows_scanned`
+  and, when the profiling settings of the connection enable them, the memory metrics
+  (`:system_peak_buffer_memory`, ...). The `:extra_info` is a map of the operator details and
+  the `:children` is a list of the child nodes. The root node holds the query-wide metrics
+  (`:query_name`, `:latency`, `:rows_returned`, ...).
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> nil = Duckdbex.profiling_tree(conn)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM range(10);", [], profile: true)
+    iex> %{children: [%{operator_type: _, children: _} | _]} = Duckdbex.profiling_tree(res)
+    iex> %{children: [_ | _]} = Duckdbex.profiling_tree(conn)
+  """
+  @spec profiling_tree(connection() | statement() | query_result()) :: map() | nil
+  def profiling_tree(resource) when is_reference(resource),
+    do: Duckdbex.NIF.profiling_tree(resource)
+
   @doc """
   Returns columns names from the query result.
 
@@ -328,6 +643,183 @@ defmodule Duckdbex do
   def fetch_all(query_result) when is_reference(query_result),
     do: Duckdbex.NIF.fetch_all(query_result)
 
+  @doc """
+  Fetches a data chunk from the query result as a list of columns.
+
+  Each column is a list of the chunk values, columns are in the same order as `columns/1` returns.
+  Returns empty list if there are no more results to fetch.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM (VALUES (1, 'one'), (2, 'two'));")
+    iex> [[1, 2], ["one", "two"]] = Duckdbex.fetch_chunk_columns(res)
+    iex> [] = Duckdbex.fetch_chunk_columns(res)
+  """
+  @spec fetch_chunk_columns(query_result()) :: list(list()) | {:error, reason()}
+  def fetch_chunk_columns(query_result) when is_reference(query_result),
+    do: Duckdbex.NIF.fetch_chunk_columns(query_result)
+
+  @doc """
+  Fetches all data from the query result as a list of columns.
+
+  Each column is a list of all the result values, columns are in the same order as `columns/1` returns.
+  If there is no data to fetch every column is an empty list.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM (VALUES (1, 'one'), (2, 'two')) t(n, name);")
+    iex> columns = Duckdbex.columns(res)
+    iex> %{"n" => [1, 2], "name" => ["one", "two"]} = Enum.zip(columns, Duckdbex.fetch_all_columns(res)) |> Map.new()
+  """
+  @spec fetch_all_columns(query_result()) :: list(list()) | {:error, reason()}
+  def fetch_all_columns(query_result) when is_reference(query_result),
+    do: Duckdbex.NIF.fetch_all_columns(query_result)
+
+  @doc """
+  Fetches a data chunk from the query result as a list of packed columns.
+
+  The fixed-width columns (boolean, integers, floats, dates, times and timestamps) are returned
+  as `{type, data, validity}` tuples: `data` is a binary of the column values in the native-endian
+  DuckDB layout, `validity` is a bitmap (least significant bit first, the bit is set for not NULL rows) or `nil` if the column has no NULLs.
+  The values of NULL rows in `data` are undefined. LIST and fixed-size ARRAY columns of such types
+  (e.g. `FLOAT[384]` embeddings) are returned as `{{:list | :array, type}, rows, validity}` tuples:
+  `rows` is a list of per-row binaries of the elements in the same layout (`nil` for NULL rows),
+  `validity` is `nil` if no element is NULL, otherwise a list of the per-row element bitmaps (`nil`
+  for the rows without NULL elements). Other columns are returned as lists of values.
+  Returns empty list if there are no more results to fetch.
+
+  The packed temporal values are 32 or 64-bit integers:
+
+    * `DATE` - days since the epoch (32 bits)
+    * `TIME` - microseconds since midnight
+    * `TIMESTAMP` and `TIMESTAMP WITH TIME ZONE` - microseconds since the epoch (UTC)
+    * `TIMESTAMP_NS` - nanoseconds since the epoch
+    * `TIMESTAMP_MS` - milliseconds since the epoch
+    * `TIMESTAMP_S` - seconds since the epoch
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM (VALUES (1, 'one'), (2, 'two'));")
+    iex> [{:integer, <<1::32-native, 2::32-native>>, nil}, ["one", "two"]] = Duckdbex.fetch_chunk_packed(res)
+    iex> [] = Duckdbex.fetch_chunk_packed(res)
+  """
+  @spec fetch_chunk_packed(query_result()) :: list(tuple() | list()) | {:error, reason()}
+  def fetch_chunk_packed(query_result) when is_reference(query_result),
+    do: Duckdbex.NIF.fetch_chunk_packed(query_result)
+
+  @doc """
+  Issues a query on the NIF worker threads, see `query/4`.
+
+  Returns a reference at once, the result of the query comes to the caller as the
+  `{:duckdbex, ref, result}` message, where `result` is what `query/4` returns.
+  Use `await/2` to wait for it. The bad arguments raise at once, the ones found only when
+  the job runs (e.g. the resource released meanwhile) come as `{:error, :badarg}`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, ref} = Duckdbex.query_async(conn, "SELECT 1 WHERE $1 = 1;", [1])
+    iex> {:ok, res} = Duckdbex.await(ref)
+    iex> [[1]] = Duckdbex.fetch_all(res)
+  """
+  @spec query_async(connection(), binary(), list(), keyword()) :: {:ok, reference()} | {:error, reason()}
+  def query_async(connection, sql_string, args \\ [], opts \\ [])
+      when is_reference(connection) and is_binary(sql_string) and is_list(args) and is_list(opts),
+      do: Duckdbex.NIF.query_async(connection, sql_string, args, opts)
+
+  @doc """
+  Executes the prepared statement on the NIF worker threads, see `execute_statement/3` and `query_async/4`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT 1 WHERE $1 = 1;")
+    iex> {:ok, ref} = Duckdbex.execute_statement_async(stmt, [1])
+    iex> {:ok, res} = Duckdbex.await(ref)
+    iex> [[1]] = Duckdbex.fetch_all(res)
+  """
+  @spec execute_statement_async(statement(), list(), keyword()) :: {:ok, reference()} | {:error, reason()}
+  def execute_statement_async(statement, args \\ [], opts \\ [])
+      when is_reference(statement) and is_list(args) and is_list(opts),
+      do: Duckdbex.NIF.execute_statement_async(statement, args, opts)
+
+  @doc """
+  Issues a query on an idle connection of the pool on the NIF worker threads, see `pool_query/4` and `query_async/4`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, pool} = Duckdbex.connection_pool(db, 2)
+    iex> {:ok, ref} = Duckdbex.pool_query_async(pool, "SELECT 1;")
+    iex> {:ok, res} = Duckdbex.await(ref)
+    iex> [[1]] = Duckdbex.fetch_all(res)
+  """
+  @spec pool_query_async(connection_pool(), binary(), list(), keyword()) :: {:ok, reference()} | {:error, reason()}
+  def pool_query_async(pool, sql_string, args \\ [], opts \\ [])
+      when is_reference(pool) and is_binary(sql_string) and is_list(args) and is_list(opts),
+      do: Duckdbex.NIF.pool_query_async(pool, sql_string, args, opts)
+
+  @doc """
+  Fetches a data chunk on the NIF worker threads, see `fetch_chunk/1` and `query_async/4`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT 1;")
+    iex> {:ok, ref} = Duckdbex.fetch_chunk_async(res)
+    iex> [[1]] = Duckdbex.await(ref)
+  """
+  @spec fetch_chunk_async(query_result()) :: {:ok, reference()} | {:error, reason()}
+  def fetch_chunk_async(query_result) when is_reference(query_result),
+    do: Duckdbex.NIF.fetch_chunk_async(query_result)
+
+  @doc """
+  Fetches all data on the NIF worker threads, see `fetch_all/1` and `query_async/4`.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT 1;")
+    iex> {:ok, ref} = Duckdbex.fetch_all_async(res)
+    iex> [[1]] = Duckdbex.await(ref)
+  """
+  @spec fetch_all_async(query_result()) :: {:ok, reference()} | {:error, reason()}
+  def fetch_all_async(query_result) when is_reference(query_result),
+    do: Duckdbex.NIF.fetch_all_async(query_result)
+
+  @doc """
+  Waits for the result of the async call.
+
+  Takes the `{:ok, ref}` returned by the async call or just the `ref`.
+  Returns `{:error, :await_timeout}` if the result does not come in `timeout` milliseconds.
+  The call may still be running then (unlike `{:error, :timeout}` of the `:timeout` query option,
+  which means the query was interrupted), the late result message is not flushed.
+  """
+  @spec await({:ok, reference()} | {:error, reason()} | reference(), timeout()) :: term()
+  def await(ref, timeout \\ :infinity)
+
+  def await({:ok, ref}, timeout), do: await(ref, timeout)
+
+  def await({:error, _reason} = error, _timeout), do: error
+
+  def await(ref, timeout) when is_reference(ref) do
+    receive do
+      {:duckdbex, ^ref, result} -> result
+    after
+      timeout -> {:error, :await_timeout}
+    end
+  end
+
   @doc """
   Creates the Appender to load bulk data into a DuckDB database.
 
@@ -396,6 +888,89 @@ defmodule Duckdbex do
   def appender_add_rows(appender, rows) when is_reference(appender) and is_list(rows),
     do: Duckdbex.NIF.appender_add_rows(appender, rows)
 
+  @doc """
+  Append the columns into a DuckDB database table at once.
+
+  Takes a list of values for every column of the table, all the columns must have the same length. The values are written into the DuckDB vectors directly and appended chunk by chunk (2048 rows), which is much cheaper than appending them row by row. If a value can't be converted the error is returned, the chunks before the failed one are already appended.
+
+  The numeric, boolean and temporal columns can also be given packed, as `fetch_chunk_packed/1` returns them: a binary of the values in the DuckDB in-memory layout (native-endian, the temporal values in the units `fetch_chunk_packed/1` lists) or a `{data, validity}` tuple, where `validity` is a bitmap (LSB first, the bit is set for not NULL rows) or `nil`. The packed data is copied into the vectors as is.
+  The rows of LIST and fixed-size ARRAY columns of such types may be binaries of the elements in the same layout, e.g. `<<1.0::float-native-32, 2.0::float-native-32>>` for `FLOAT[2]`; query parameters and appended rows take them too.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, _res} = Duckdbex.query(conn, "CREATE TABLE table_1 (the_n1 INTEGER, the_str1 STRING);")
+    iex> {:ok, appender} = Duckdbex.appender(conn, "table_1")
+    iex> :ok = Duckdbex.appender_add_columns(appender, [[1, 2, nil], ["one", "two", "three"]])
+    iex> :ok = Duckdbex.appender_flush(appender)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM table_1;")
+    iex> [[1, "one"], [2, "two"], [nil, "three"]] = Duckdbex.fetch_all(res)
+    iex> :ok = Duckdbex.appender_add_columns(appender, [{<<4::native-32, 5::native-32>>, <<0b01>>}, ["four", "five"]])
+    iex> :ok = Duckdbex.appender_flush(appender)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM table_1 WHERE the_str1 IN ('four', 'five');")
+    iex> [[4, "four"], [nil, "five"]] = Duckdbex.fetch_all(res)
+  """
+  @spec appender_add_columns(appender(), [list() | binary() | {binary(), binary() | nil}]) :: :ok | {:error, reason()}
+  def appender_add_columns(appender, columns) when is_reference(appender) and is_list(columns),
+    do: Duckdbex.NIF.appender_add_columns(appender, columns)
+
+  @doc """
+  Creates the Appender fed from its own thread.
+
+  `async_appender_add_rows/2` copies the rows into the queue of the appender and returns at once, the thread appends them and flushes the appender by the policy given in the options. The appender is closed by `async_appender_close/1` or, after the queued rows are appended, when the process created it exits.
+
+  Options:
+    * `:schema` - the schema of the table.
+    * `:max_pending_rows` - the rows queued but not appended yet, `async_appender_add_rows/2` returns `{:error, :busy}` when the queue is full (`100_000` by default).
+    * `:flush_rows` - flush every that many appended rows.
+    * `:flush_bytes` - flush every that many appended bytes (roughly, binaries are counted by their size and other values as 8 bytes).
+    * `:flush_interval` - flush the rows appended that many milliseconds ago (`1000` by default), `:infinity` disables it.
+
+  If the appender fails to append a row, the rows before it (of the earlier batches and of its own one) are flushed, while the failed row, the rest of its batch and the batches queued after it are dropped. If the flush fails, the rows not flushed yet are lost as well. Either way the creator process receives `{:duckdbex_appender, appender, {:error, reason}}` and the appender returns the error from then on.
+
+  ## Examples
+
+    iex> {:ok, db} = Duckdbex.open()
+    iex> {:ok, conn} = Duckdbex.connection(db)
+    iex> {:ok, _res} = Duckdbex.query(conn, "CREATE TABLE table_1 (the_n1 INTEGER, the_str1 STRING);")
+    iex> {:ok, appender} = Duckdbex.async_appender(conn, "table_1", flush_rows: 1000)
+    iex> :ok = Duckdbex.async_appender_add_rows(appender, [[1, "one"], [2, "two"]])
+    iex> :ok = Duckdbex.async_appender_flush(appender)
+    iex> {:ok, res} = Duckdbex.query(conn, "SELECT * FROM table_1;")
+    iex> [[1, "one"], [2, "two"]] = Duckdbex.fetch_all(res)
+    iex> :ok = Duckdbex.async_appender_close(appender)
+  """
+  @spec async_appender(connection(), binary(), keyword()) :: {:ok, async_appender()} | {:error, reason()}
+  def async_appender(connection, table_name, opts \\ [])
+      when is_reference(connection) and is_binary(table_name) and is_list(opts) do
+    {schema_name, opts} = Keyword.pop(opts, :schema)
+    Duckdbex.NIF.async_appender(connection, schema_name, table_name, opts)
+  end
+
+  @doc """
+  Queues the rows to the async appender.
+
+  Returns `{:error, :busy}` when the queue of the appender is full, the rows are not queued then.
+  """
+  @spec async_appender_add_rows(async_appender(), list(list())) :: :ok | {:error, :busy} | {:error, reason()}
+  def async_appender_add_rows(appender, rows) when is_reference(appender) and is_list(rows),
+    do: Duckdbex.NIF.async_appender_add_rows(appender, rows)
+
+  @doc """
+  Waits until the rows queued before are appended and flushed.
+  """
+  @spec async_appender_flush(async_appender()) :: :ok | {:error, reason()}
+  def async_appender_flush(appender) when is_reference(appender),
+    do: Duckdbex.NIF.async_appender_flush(appender)
+
+  @doc """
+  Appends the queued rows, flushes and closes the async appender.
+  """
+  @spec async_appender_close(async_appender()) :: :ok | {:error, reason()}
+  def async_appender_close(appender) when is_reference(appender),
+    do: Duckdbex.NIF.async_appender_close(appender)
+
   @doc """
   Commit the changes made by the appender.
 
@@ -10,36 +10,68 @@ defmodule Duckdbex.NIF do
   @type query_result() :: reference()
   @type statement() :: reference()
   @type appender :: reference()
+  @type async_appender :: reference()
+  @type connection_pool() :: reference()
   @type reason() :: :atom | binary()
 
   def init() do
-    :erlang.load_nif(String.to_charlist(Path.join(:code.priv_dir(:duckdbex), "duckdb_nif")), 0)
+    :erlang.load_nif(
+      String.to_charlist(Path.join(:code.priv_dir(:duckdbex), "duckdb_nif")),
+      Application.get_env(:duckdbex, :async_workers, 0)
+    )
   end
 
   @spec create_config() :: {:ok, config()} | {:error, reason()}
   def create_config(), do: :erlang.nif_error(:not_loaded)
 
+  @spec create_config(keyword()) :: {:ok, config()} | {:error, reason()}
+  def create_config(_opts), do: :erlang.nif_error(:not_loaded)
+
   @spec set_config_option(config(), binary() | atom(), term()) :: :ok | {:error, reason()}
   def set_config_option(_config, _name, _value), do: :erlang.nif_error(:not_loaded)
 
   @spec get_config_options() :: list(map())
   def get_config_options(), do: :erlang.nif_error(:not_loaded)
 
-  @spec release(config() | db() | connection() | statement() | query_result() | appender()) :: :ok
+  @spec release(config() | db() | connection() | connection_pool() | statement() | query_result() | appender()) :: :ok
   def release(_resource), do: :erlang.nif_error(:not_loaded)
 
   @spec open(binary(), config() | nil) :: {:ok, db()} | {:error, reason()}
   def open(_path, _config), do: :erlang.nif_error(:not_loaded)
 
+  @spec allocator_stats(db()) :: map() | nil
+  def allocator_stats(_db), do: :erlang.nif_error(:not_loaded)
+
+  @spec set_telemetry_collector(pid() | nil) :: :ok
+  def set_telemetry_collector(_pid), do: :erlang.nif_error(:not_loaded)
+
   @spec connection(db()) :: {:ok, connection()} | {:error, reason()}
   def connection(_database), do: :erlang.nif_error(:not_loaded)
 
+  @spec connection(db(), keyword()) :: {:ok, connection()} | {:error, reason()}
+  def connection(_db, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec statement_cache_stats(connection()) :: map()
+  def statement_cache_stats(_connection), do: :erlang.nif_error(:not_loaded)
+
+  @spec clear_statement_cache(connection()) :: :ok
+  def clear_statement_cache(_connection), do: :erlang.nif_error(:not_loaded)
+
+  @spec connection_pool(db(), pos_integer()) :: {:ok, connection_pool()} | {:error, reason()}
+  def connection_pool(_db, _size), do: :erlang.nif_error(:not_loaded)
+
+  @spec pool_query(connection_pool(), binary(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def pool_query(_pool, _string_sql, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
   @spec query(connection(), binary()) :: {:ok, query_result()} | {:error, reason()}
   def query(_connection, _string_sql), do: :erlang.nif_error(:not_loaded)
 
   @spec query(connection(), binary(), list()) :: {:ok, query_result()} | {:error, reason()}
   def query(_connection, _string_sql, _args), do: :erlang.nif_error(:not_loaded)
 
+  @spec query(connection(), binary(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def query(_connection, _string_sql, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
   @spec prepare_statement(connection(), binary()) :: {:ok, statement()} | {:error, reason()}
   def prepare_statement(_connection, _string_sql), do: :erlang.nif_error(:not_loaded)
 
@@ -49,6 +81,22 @@ defmodule Duckdbex.NIF do
   @spec execute_statement(statement(), list()) :: {:ok, query_result()} | {:error, reason()}
   def execute_statement(_statement, _args), do: :erlang.nif_error(:not_loaded)
 
+  @spec execute_statement(statement(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def execute_statement(_statement, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec execute_statement_many(statement(), [list()], keyword()) ::
+          {:ok, integer()} | {:error, {non_neg_integer(), reason()}} | {:error, reason()}
+  def execute_statement_many(_statement, _rows, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec cancel(connection() | statement()) :: :ok
+  def cancel(_connection_or_statement), do: :erlang.nif_error(:not_loaded)
+
+  @spec query_cooperative(connection(), binary(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def query_cooperative(_connection, _string_sql, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec execute_statement_cooperative(statement(), list(), keyword()) :: {:ok, query_result()} | {:error, reason()}
+  def execute_statement_cooperative(_statement, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
   @spec begin_transaction(connection()) :: :ok | {:error, reason()}
   def begin_transaction(_conn), do: :erlang.nif_error(:not_loaded)
 
@@ -67,6 +115,15 @@ defmodule Duckdbex.NIF do
   @spec has_active_transaction(connection()) :: {:ok, boolean()} | {:error, reason()}
   def has_active_transaction(_conn), do: :erlang.nif_error(:not_loaded)
 
+  @spec enable_profiling(connection()) :: :ok
+  def enable_profiling(_conn), do: :erlang.nif_error(:not_loaded)
+
+  @spec disable_profiling(connection()) :: :ok
+  def disable_profiling(_conn), do: :erlang.nif_error(:not_loaded)
+
+  @spec profiling_tree(connection() | statement() | query_result()) :: map() | nil
+  def profiling_tree(_resource), do: :erlang.nif_error(:not_loaded)
+
   @spec columns(query_result()) :: list(binary()) | {:error, reason()}
   def columns(_query_result), do: :erlang.nif_error(:not_loaded)
 
@@ -76,6 +133,30 @@ defmodule Duckdbex.NIF do
   @spec fetch_all(query_result()) :: list() | {:error, reason()}
   def fetch_all(_query_result), do: :erlang.nif_error(:not_loaded)
 
+  @spec fetch_chunk_columns(query_result()) :: list(list()) | {:error, reason()}
+  def fetch_chunk_columns(_query_result), do: :erlang.nif_error(:not_loaded)
+
+  @spec fetch_all_columns(query_result()) :: list(list()) | {:error, reason()}
+  def fetch_all_columns(_query_result), do: :erlang.nif_error(:not_loaded)
+
+  @spec fetch_chunk_packed(query_result()) :: list(tuple() | list()) | {:error, reason()}
+  def fetch_chunk_packed(_query_result), do: :erlang.nif_error(:not_loaded)
+
+  @spec query_async(connection(), binary(), list(), keyword()) :: {:ok, reference()} | {:error, reason()}
+  def query_async(_connection, _string_sql, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec execute_statement_async(statement(), list(), keyword()) :: {:ok, reference()} | {:error, reason()}
+  def execute_statement_async(_statement, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec pool_query_async(connection_pool(), binary(), list(), keyword()) :: {:ok, reference()} | {:error, reason()}
+  def pool_query_async(_pool, _string_sql, _args, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec fetch_chunk_async(query_result()) :: {:ok, reference()} | {:error, reason()}
+  def fetch_chunk_async(_query_result), do: :erlang.nif_error(:not_loaded)
+
+  @spec fetch_all_async(query_result()) :: {:ok, reference()} | {:error, reason()}
+  def fetch_all_async(_query_result), do: :erlang.nif_error(:not_loaded)
+
   @spec appender(connection(), binary()) :: {:ok, appender()} | {:error, reason()}
   def appender(_connection, _table_name), do: :erlang.nif_error(:not_loaded)
 
@@ -88,6 +169,21 @@ defmodule Duckdbex.NIF do
   @spec appender_add_rows(appender(), list(list())) :: :ok | {:error, reason()}
   def appender_add_rows(_appender, _rows), do: :erlang.nif_error(:not_loaded)
 
+  @spec appender_add_columns(appender(), [list() | binary() | {binary(), binary() | nil}]) :: :ok | {:error, reason()}
+  def appender_add_columns(_appender, _columns), do: :erlang.nif_error(:not_loaded)
+
+  @spec async_appender(connection(), binary() | nil, binary(), keyword()) :: {:ok, async_appender()} | {:error, reason()}
+  def async_appender(_connection, _schema_name, _table_name, _opts), do: :erlang.nif_error(:not_loaded)
+
+  @spec async_appender_add_rows(async_appender(), list(list())) :: :ok | {:error, :busy} | {:error, reason()}
+  def async_appender_add_rows(_appender, _rows), do: :erlang.nif_error(:not_loaded)
+
+  @spec async_appender_flush(async_appender()) :: :ok | {:error, reason()}
+  def async_appender_flush(_appender), do: :erlang.nif_error(:not_loaded)
+
+  @spec async_appender_close(async_appender()) :: :ok | {:error, reason()}
+  def async_appender_close(_appender), do: :erlang.nif_error(:not_loaded)
+
   @spec appender_flush(appender()) :: :ok | {:error, reason()}
   def appender_flush(_appender), do: :erlang.nif_error(:not_loaded)
 
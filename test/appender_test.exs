@@ -103,4 +103,295 @@ defmodule Duckdbex.AppenderTest do
     assert [[123]] =
              Duckdbex.fetch_all(r)
   end
+
+  test "append rows of the typed columns", %{conn: conn} do
+    {:ok, _} =
+      Duckdbex.query(conn, """
+        CREATE TABLE appender_test_1(
+          tinyint TINYINT,
+          ubigint UBIGINT,
+          float FLOAT,
+          boolean BOOLEAN,
+          varchar VARCHAR,
+          blob BLOB);
+      """)
+
+    assert {:ok, appender} = Duckdbex.appender(conn, "appender_test_1")
+
+    assert :ok =
+             Duckdbex.appender_add_rows(appender, [
+               [-128, 18_446_744_073_709_551_615, 1, true, :atom, <<0, 1>>],
+               [nil, nil, 0.5, nil, "string", nil]
+             ])
+
+    assert :ok = Duckdbex.appender_flush(appender)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT * FROM appender_test_1;")
+
+    assert [
+             [-128, 18_446_744_073_709_551_615, 1.0, true, "atom", <<0, 1>>],
+             [nil, nil, 0.5, nil, "string", nil]
+           ] = Duckdbex.fetch_all(r)
+
+    assert {:ok, appender} = Duckdbex.appender(conn, "appender_test_1")
+
+    assert {:error, "invalid type of column: 4"} =
+             Duckdbex.appender_add_row(appender, [1, 1, 1.0, true, 2, "b"])
+
+    assert {:error, "invalid type of column: 4"} =
+             Duckdbex.appender_add_row(appender, [1, 1, 1.0, true, <<0xC3, 0x28>>, "b"])
+
+    assert {:error, "invalid type of column: 0"} =
+             Duckdbex.appender_add_row(appender, [128, 1, 1.0, true, "s", "b"])
+
+    # the failed rows are dropped, the appender is usable
+    assert :ok = Duckdbex.appender_add_row(appender, [1, 2, 3.0, false, "s", "b"])
+    assert :ok = Duckdbex.appender_close(appender)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM appender_test_1;")
+    assert [[3]] = Duckdbex.fetch_all(r)
+  end
+
+  test "append columns", %{conn: conn} do
+    {:ok, _} =
+      Duckdbex.query(conn, """
+        CREATE TABLE appender_test_1(
+          bigint BIGINT,
+          smallint SMALLINT,
+          boolean BOOLEAN,
+          double DOUBLE,
+          varchar VARCHAR,
+          date DATE);
+      """)
+
+    assert {:ok, appender} = Duckdbex.appender(conn, "appender_test_1")
+
+    n = 5000
+
+    assert :ok =
+             Duckdbex.appender_add_columns(appender, [
+               Enum.to_list(1..n),
+               Enum.map(1..n, &rem(&1, 100)),
+               Enum.map(1..n, &(rem(&1, 2) == 0)),
+               Enum.map(1..n, &if(rem(&1, 10) == 0, do: nil, else: &1 / 2)),
+               Enum.map(1..n, &"s#{&1}"),
+               Enum.map(1..n, fn _ -> {2024, 1, 31} end)
+             ])
+
+    assert :ok = Duckdbex.appender_flush(appender)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT count(*), count(double), sum(bigint) FROM appender_test_1;")
+    assert [[5000, 4500, 12_502_500]] = Duckdbex.fetch_all(r)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT * FROM appender_test_1 WHERE bigint = 4096;")
+    assert [[4096, 96, true, 2048.0, "s4096", {2024, 1, 31}]] = Duckdbex.fetch_all(r)
+  end
+
+  test "append nested columns", %{conn: conn} do
+    {:ok, _} =
+      Duckdbex.query(conn, """
+        CREATE TABLE appender_test_1(
+          list INTEGER[],
+          events STRUCT(name VARCHAR, tags VARCHAR[])[],
+          attributes MAP(VARCHAR, INTEGER),
+          point INTEGER[3]);
+      """)
+
+    assert {:ok, appender} = Duckdbex.appender(conn, "appender_test_1")
+
+    assert :ok =
+             Duckdbex.appender_add_columns(appender, [
+               [[1, 2, 3], [], nil],
+               [
+                 [%{"name" => "a", "tags" => ["x", "y"]}, %{"name" => "b", "tags" => nil}],
+                 nil,
+                 [%{"name" => "c", "tags" => []}]
+               ],
+               [[{"k1", 1}, {"k2", nil}], nil, []],
+               [[1, 2, 3], nil, [4, 5, 6]]
+             ])
+
+    assert :ok = Duckdbex.appender_flush(appender)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT * FROM appender_test_1;")
+
+    assert [
+             [
+               [1, 2, 3],
+               [%{"name" => "a", "tags" => ["x", "y"]}, %{"name" => "b", "tags" => nil}],
+               [{"k1", 1}, {"k2", nil}],
+               [1, 2, 3]
+             ],
+             [[], nil, nil, nil],
+             [nil, [%{"name" => "c", "tags" => []}], [], [4, 5, 6]]
+           ] = Duckdbex.fetch_all(r)
+
+    assert {:error, "invalid type of column: 3"} =
+             Duckdbex.appender_add_columns(appender, [[nil], [nil], [nil], [[1, 2]]])
+
+    assert {:error, "invalid type of column: 1"} =
+             Duckdbex.appender_add_columns(appender, [[nil], [[%{"name" => "a"}]], [nil], [nil]])
+  end
+
+  test "append columns of large strings and blobs", %{conn: conn} do
+    {:ok, _} = Duckdbex.query(conn, "CREATE TABLE appender_test_1(s VARCHAR, b BLOB);")
+
+    large = String.duplicate("0123456789", 100_000)
+    chunks = for i <- 1..3000, do: "string #{i} longer than the inlined one"
+
+    assert {:ok, appender} = Duckdbex.appender(conn, "appender_test_1")
+    assert :ok = Duckdbex.appender_add_columns(appender, [[large, "short", nil], [[large, "!"], "short", nil]])
+    assert :ok = Duckdbex.appender_add_columns(appender, [chunks, chunks])
+    assert :ok = Duckdbex.appender_close(appender)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT * FROM appender_test_1 LIMIT 3;")
+    large_blob = large <> "!"
+    assert [[^large, ^large_blob], ["short", "short"], [nil, nil]] = Duckdbex.fetch_all(r)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT list(s ORDER BY rowid) FROM appender_test_1 WHERE rowid >= 3;")
+    assert [[^chunks]] = Duckdbex.fetch_all(r)
+  end
+
+  test "append columns with the incorrect values", %{conn: conn} do
+    {:ok, _} = Duckdbex.query(conn, "CREATE TABLE appender_test_1(i INTEGER, s VARCHAR);")
+
+    assert {:ok, appender} = Duckdbex.appender(conn, "appender_test_1")
+
+    assert_raise ArgumentError, fn -> Duckdbex.appender_add_columns(appender, [[1, 2], ["one"]]) end
+    assert_raise ArgumentError, fn -> Duckdbex.appender_add_columns(appender, [[1]]) end
+
+    assert {:error, "invalid type of column: 0"} =
+             Duckdbex.appender_add_columns(appender, [[1, 5_000_000_000], ["one", "two"]])
+
+    assert {:error, "invalid type of column: 1"} =
+             Duckdbex.appender_add_columns(appender, [[1, 2], ["one", 2]])
+
+    assert {:error, "invalid type of column: 1"} =
+             Duckdbex.appender_add_columns(appender, [[1, 2], ["one", <<0xFF, 0xFE>>]])
+  end
+
+  test "append packed columns", %{conn: conn} do
+    {:ok, _} =
+      Duckdbex.query(conn, "CREATE TABLE appender_test_1(i BIGINT, d DOUBLE, b BOOLEAN, s VARCHAR);")
+
+    assert {:ok, appender} = Duckdbex.appender(conn, "appender_test_1")
+
+    n = 3000
+    ints = for i <- 1..n, into: <<>>, do: <<i::signed-native-64>>
+    doubles = for i <- 1..n, into: <<>>, do: <<i / 4::float-native-64>>
+    bools = for i <- 1..n, into: <<>>, do: <<rem(i, 2)>>
+    # every 8th row is NULL
+    validity = for _ <- 1..div(n + 7, 8), into: <<>>, do: <<0b11111110>>
+
+    assert :ok =
+             Duckdbex.appender_add_columns(appender, [
+               ints,
+               {doubles, validity},
+               {bools, nil},
+               Enum.map(1..n, &Integer.to_string/1)
+             ])
+
+    assert :ok = Duckdbex.appender_flush(appender)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT count(*), count(d), sum(i), count_if(b) FROM appender_test_1;")
+    assert [[3000, 2625, 4_501_500, 1500]] = Duckdbex.fetch_all(r)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT * FROM appender_test_1 WHERE i IN (2, 3) ORDER BY i;")
+    assert [[2, 0.5, false, "2"], [3, 0.75, true, "3"]] = Duckdbex.fetch_all(r)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT * FROM appender_test_1 WHERE i = 2049;")
+    assert [[2049, nil, true, "2049"]] = Duckdbex.fetch_all(r)
+
+    # the size of the binary is not the multiple of the type width
+    assert_raise ArgumentError, fn ->
+      Duckdbex.appender_add_columns(appender, [<<1::32>>, <<0::64>>, <<1>>, ["1"]])
+    end
+
+    # the packed column of the not fixed-width type
+    assert_raise ArgumentError, fn ->
+      Duckdbex.appender_add_columns(appender, [<<1::64>>, <<0::64>>, <<1>>, "1"])
+    end
+  end
+
+  describe "async appender" do
+    test "appends and flushes the rows", %{conn: conn} do
+      {:ok, _} = Duckdbex.query(conn, "CREATE TABLE appender_test_1(i INTEGER, s VARCHAR);")
+
+      assert {:ok, appender} = Duckdbex.async_appender(conn, "appender_test_1", flush_rows: 100)
+
+      for i <- 1..10 do
+        assert :ok = Duckdbex.async_appender_add_rows(appender, Enum.map(1..50, &[i * 100 + &1, "s"]))
+      end
+
+      assert :ok = Duckdbex.async_appender_flush(appender)
+      {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM appender_test_1;")
+      assert [[500]] = Duckdbex.fetch_all(r)
+
+      assert :ok = Duckdbex.async_appender_close(appender)
+      assert {:error, "appender is closed"} = Duckdbex.async_appender_add_rows(appender, [[1, "s"]])
+      assert {:error, "appender is closed"} = Duckdbex.async_appender_close(appender)
+    end
+
+    test "flushes by the interval", %{conn: conn} do
+      {:ok, _} = Duckdbex.query(conn, "CREATE TABLE appender_test_1(i INTEGER);")
+
+      assert {:ok, appender} = Duckdbex.async_appender(conn, "appender_test_1", flush_interval: 10)
+      assert :ok = Duckdbex.async_appender_add_rows(appender, [[1], [2]])
+
+      assert wait_for(fn ->
+               {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM appender_test_1;")
+               Duckdbex.fetch_all(r) == [[2]]
+             end)
+    end
+
+    test "reports the failure to the owner", %{conn: conn} do
+      {:ok, _} = Duckdbex.query(conn, "CREATE TABLE appender_test_1(i INTEGER);")
+
+      assert {:ok, appender} = Duckdbex.async_appender(conn, "appender_test_1", flush_interval: :infinity)
+      assert :ok = Duckdbex.async_appender_add_rows(appender, [[1], ["not an integer"]])
+
+      assert_receive {:duckdbex_appender, ^appender, {:error, "invalid type of column: 0"}}
+      assert {:error, "invalid type of column: 0"} = Duckdbex.async_appender_flush(appender)
+      assert {:error, "invalid type of column: 0"} = Duckdbex.async_appender_add_rows(appender, [[2]])
+
+      {:ok, r} = Duckdbex.query(conn, "SELECT * FROM appender_test_1;")
+      assert [[1]] = Duckdbex.fetch_all(r)
+    end
+
+    test "validates the rows and the options", %{conn: conn} do
+      {:ok, _} = Duckdbex.query(conn, "CREATE TABLE appender_test_1(i INTEGER, j INTEGER);")
+
+      assert {:error, "Table 'unknown' could not be found"} = Duckdbex.async_appender(conn, "unknown")
+      assert_raise ArgumentError, fn -> Duckdbex.async_appender(conn, "appender_test_1", max_pending_rows: 0) end
+
+      assert {:ok, appender} = Duckdbex.async_appender(conn, "appender_test_1")
+      assert_raise ArgumentError, fn -> Duckdbex.async_appender_add_rows(appender, [[1]]) end
+      assert_raise ArgumentError, fn -> Duckdbex.async_appender_add_rows(appender, [1, 2]) end
+    end
+
+    test "is closed with the queued rows appended when the owner exits", %{conn: conn} do
+      {:ok, _} = Duckdbex.query(conn, "CREATE TABLE appender_test_1(i INTEGER);")
+
+      {pid, ref} =
+        spawn_monitor(fn ->
+          {:ok, appender} = Duckdbex.async_appender(conn, "appender_test_1", flush_interval: :infinity)
+          :ok = Duckdbex.async_appender_add_rows(appender, Enum.map(1..1000, &[&1]))
+        end)
+
+      assert_receive {:DOWN, ^ref, :process, ^pid, :normal}
+
+      assert wait_for(fn ->
+               {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM appender_test_1;")
+               Duckdbex.fetch_all(r) == [[1000]]
+             end)
+    end
+  end
+
+  defp wait_for(fun, attempts \\ 100) do
+    cond do
+      fun.() -> true
+      attempts == 0 -> false
+      true -> Process.sleep(10) && wait_for(fun, attempts - 1)
+    end
+  end
 end
@@ -0,0 +1,77 @@
+defmodule Duckdbex.AsyncTest do
+  use ExUnit.Case
+
+  setup ctx do
+    {:ok, db} = Duckdbex.open(":memory:", nil)
+    {:ok, conn} = Duckdbex.connection(db)
+    Map.put(ctx, :conn, conn)
+  end
+
+  test "query_async sends the result to the caller", %{conn: conn} do
+    assert {:ok, ref} = Duckdbex.query_async(conn, "SELECT * FROM range(3);")
+    assert_receive {:duckdbex, ^ref, {:ok, result_ref}}, 5_000
+
+    assert {:ok, ref} = Duckdbex.fetch_all_async(result_ref)
+    assert [[0], [1], [2]] == Duckdbex.await(ref)
+  end
+
+  test "query_async sends the error to the caller", %{conn: conn} do
+    assert {:error, "Parser Error: " <> _} =
+             conn |> Duckdbex.query_async("SELEC 1;") |> Duckdbex.await()
+
+    assert {:error, "invalid type of parameter #1"} =
+             conn |> Duckdbex.query_async("SELECT 1 WHERE $1 = 1;", ["one"]) |> Duckdbex.await()
+  end
+
+  test "query_async raises on bad arguments", %{conn: conn} do
+    assert_raise ArgumentError, fn -> Duckdbex.query_async(conn, "SELECT 1;", [], unknown: true) end
+    assert_raise ArgumentError, fn -> Duckdbex.query_async(conn, "SELECT $1;", [1 | 2]) end
+
+    {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT $1;")
+    assert_raise ArgumentError, fn -> Duckdbex.execute_statement_async(stmt, [1 | 2]) end
+  end
+
+  test "the result released before the job runs is sent as the badarg error", %{conn: conn} do
+    {:ok, res} = Duckdbex.query(conn, "SELECT * FROM range(100000);", [], stream: true)
+
+    refs = for _ <- 1..50, do: Duckdbex.fetch_chunk_async(res)
+    :ok = Duckdbex.release(res)
+
+    for ref <- refs do
+      assert result = Duckdbex.await(ref, 10_000)
+      assert is_list(result) or result == {:error, :badarg}
+    end
+
+    assert_raise ArgumentError, fn -> Duckdbex.fetch_chunk_async(res) end
+  end
+
+  test "execute_statement_async and fetch_chunk_async", %{conn: conn} do
+    {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT * FROM range($1);")
+
+    assert {:ok, result_ref} = stmt |> Duckdbex.execute_statement_async([5000]) |> Duckdbex.await()
+
+    chunks =
+      Stream.repeatedly(fn -> result_ref |> Duckdbex.fetch_chunk_async() |> Duckdbex.await() end)
+      |> Enum.take_while(&(&1 != []))
+
+    assert Enum.map(0..4999, &[&1]) == Enum.concat(chunks)
+  end
+
+  test "many concurrent async queries", %{conn: conn} do
+    refs =
+      for i <- 1..200 do
+        {:ok, ref} = Duckdbex.query_async(conn, "SELECT $1::INTEGER * 2;", [i])
+        {i, ref}
+      end
+
+    for {i, ref} <- refs do
+      assert {:ok, result_ref} = Duckdbex.await(ref, 10_000)
+      assert [[i * 2]] == Duckdbex.fetch_all(result_ref)
+    end
+  end
+
+  test "await gives up with its own reason", %{conn: conn} do
+    assert {:error, :await_timeout} = Duckdbex.await(make_ref(), 10)
+    assert {:ok, _} = conn |> Duckdbex.query_async("SELECT 1;") |> Duckdbex.await()
+  end
+end
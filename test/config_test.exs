@@ -6,6 +6,26 @@ defmodule Duckdbex.Nif.ConfigTest do
     assert is_reference(config)
   end
 
+  test "erlang allocator" do
+    assert {:ok, config} = Duckdbex.create_config(allocator: :erlang)
+    assert {:ok, db} = Duckdbex.open(config)
+    assert {:ok, other_db} = Duckdbex.open(config)
+
+    {:ok, conn} = Duckdbex.connection(db)
+    {:ok, _} = Duckdbex.query(conn, "CREATE TABLE t AS SELECT i, i::VARCHAR AS s FROM range(100000) t(i);")
+
+    assert %{live_bytes: live, peak_bytes: peak, allocations: allocations} = Duckdbex.allocator_stats(db)
+    assert live > 0 and peak >= live and allocations > 0
+
+    assert %{peak_bytes: other_peak} = Duckdbex.allocator_stats(other_db)
+    assert other_peak < peak
+
+    {:ok, default_db} = Duckdbex.open(":memory:", nil)
+    assert nil == Duckdbex.allocator_stats(default_db)
+
+    assert_raise ArgumentError, fn -> Duckdbex.create_config(allocator: :arena) end
+  end
+
   test "get_config_options/0 returns DuckDB config options" do
     options = Duckdbex.get_config_options()
 
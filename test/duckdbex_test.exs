@@ -51,6 +51,213 @@ defmodule DuckdbexTest do
     assert [[1]] = Duckdbex.fetch_all(res)
   end
 
+  test "query/4 with stream option" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT * FROM range(5000);", [], stream: true)
+    assert Enum.map(0..4999, &[&1]) == Duckdbex.fetch_all(res)
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT * FROM range($1);", [3], stream: true)
+    assert [[0], [1], [2]] = Duckdbex.fetch_all(res)
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT 1;", [], stream: false)
+    assert [[1]] = Duckdbex.fetch_all(res)
+
+    assert_raise ArgumentError, fn -> Duckdbex.query(conn, "SELECT 1;", [], unknown: true) end
+  end
+
+  test "query/4 with cooperative option" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT 1;", [], cooperative: true)
+    assert [[1]] = Duckdbex.fetch_all(res)
+
+    assert {:ok, res} =
+             Duckdbex.query(conn, "SELECT sum(i) FROM range($1) t(i);", [1_000_000], cooperative: true)
+
+    assert [[499_999_500_000]] = Duckdbex.fetch_all(res)
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT * FROM range(5000);", [], cooperative: true, stream: true)
+    assert Enum.map(0..4999, &[&1]) == Duckdbex.fetch_all(res)
+
+    assert {:error, "Parser Error: " <> _} = Duckdbex.query(conn, "SELEC 1;", [], cooperative: true)
+
+    assert {:error, "Conversion Error: " <> _} =
+             Duckdbex.query(conn, "SELECT 'one'::INTEGER;", [], cooperative: true)
+  end
+
+  test "execute_statement/3 with cooperative option" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+    assert {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT * FROM range($1);")
+
+    assert {:ok, res} = Duckdbex.execute_statement(stmt, [3], cooperative: true)
+    assert [[0], [1], [2]] = Duckdbex.fetch_all(res)
+  end
+
+  test "query/4 with timeout option" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    assert {:error, :timeout} =
+             Duckdbex.query(conn, "SELECT sum(i) FROM range(10000000000000) t(i);", [], timeout: 100)
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT 1;", [], timeout: 1000)
+    assert [[1]] = Duckdbex.fetch_all(res)
+
+    assert {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT sum(i) FROM range($1) t(i);")
+    assert {:error, :timeout} = Duckdbex.execute_statement(stmt, [10_000_000_000_000], timeout: 100)
+
+    assert_raise ArgumentError, fn -> Duckdbex.query(conn, "SELECT 1;", [], timeout: 0) end
+  end
+
+  test "cancel/1" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    task =
+      Task.async(fn ->
+        Duckdbex.query(conn, "SELECT sum(i) FROM range(10000000000000) t(i);", [], [])
+      end)
+
+    result =
+      Stream.repeatedly(fn ->
+        :ok = Duckdbex.cancel(conn)
+        Task.yield(task, 50)
+      end)
+      |> Enum.find(& &1)
+
+    assert {:ok, {:error, :cancelled}} = result
+  end
+
+  test "query is interrupted when the caller exits" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    pid = spawn(fn -> Duckdbex.query(conn, "SELECT sum(i) FROM range(10000000000000) t(i);", [], []) end)
+    Process.sleep(100)
+    Process.exit(pid, :kill)
+
+    # the connection is free as soon as the query is interrupted
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT 1;", [], timeout: 10_000)
+    assert [[1]] = Duckdbex.fetch_all(res)
+  end
+
+  test "exit of the process waiting for the connection does not interrupt the running query" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    task = Task.async(fn -> Duckdbex.query(conn, "SELECT count(*) FROM range(300000000);", [], []) end)
+    Process.sleep(50)
+
+    waiting = spawn(fn -> Duckdbex.query(conn, "SELECT 1;", [], []) end)
+    Process.sleep(50)
+    Process.exit(waiting, :kill)
+
+    assert {:ok, res} = Task.await(task, 60_000)
+    assert [[300_000_000]] = Duckdbex.fetch_all(res)
+  end
+
+  test "query/4 with release_on_exit option" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    test_pid = self()
+
+    pid =
+      spawn(fn ->
+        {:ok, res} = Duckdbex.query(conn, "SELECT 1;", [], release_on_exit: true)
+        send(test_pid, {:result, res})
+        Process.sleep(:infinity)
+      end)
+
+    assert_receive {:result, res}
+    Process.exit(pid, :kill)
+    Process.sleep(100)
+
+    assert_raise ArgumentError, fn -> Duckdbex.fetch_all(res) end
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT 1;", [], release_on_exit: false)
+    assert [[1]] = Duckdbex.fetch_all(res)
+  end
+
+  test "execute_statement/3 with stream option" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+    assert {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT * FROM range($1);")
+
+    assert {:ok, res} = Duckdbex.execute_statement(stmt, [5000], stream: true)
+    assert [[0] | _] = chunk = Duckdbex.fetch_chunk(res)
+    assert 5000 - length(chunk) == length(Duckdbex.fetch_all(res))
+  end
+
+  test "query/3 caches prepared statements" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db, statement_cache_size: 2)
+
+    assert {:ok, _} = Duckdbex.query(conn, "CREATE TABLE cache_test(i INTEGER);")
+
+    for i <- 1..3 do
+      assert {:ok, _} = Duckdbex.query(conn, "INSERT INTO cache_test VALUES ($1);", [i])
+    end
+
+    assert %{size: 1, capacity: 2, hits: 2, misses: 1} = Duckdbex.statement_cache_stats(conn)
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT i FROM cache_test WHERE i > $1 ORDER BY i;", [1])
+    assert [[2], [3]] = Duckdbex.fetch_all(res)
+
+    # the cached statement is rebound after the table is changed
+    assert {:ok, _} = Duckdbex.query(conn, "ALTER TABLE cache_test ADD COLUMN j INTEGER DEFAULT 0;")
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT i FROM cache_test WHERE i > $1 ORDER BY i;", [2])
+    assert [[3]] = Duckdbex.fetch_all(res)
+
+    # the least recently used statement is dropped
+    assert {:ok, _} = Duckdbex.query(conn, "SELECT $1::INTEGER;", [1])
+    assert %{size: 2, hits: 3, misses: 3} = Duckdbex.statement_cache_stats(conn)
+
+    assert :ok = Duckdbex.clear_statement_cache(conn)
+    assert %{size: 0} = Duckdbex.statement_cache_stats(conn)
+
+    assert {:ok, conn} = Duckdbex.connection(db, statement_cache_size: 0)
+    assert {:ok, _} = Duckdbex.query(conn, "SELECT $1::INTEGER;", [1])
+    assert %{size: 0, capacity: 0} = Duckdbex.statement_cache_stats(conn)
+  end
+
+  test "connection_pool/2 and pool_query/4" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, pool} = Duckdbex.connection_pool(db, 4)
+
+    assert {:ok, conn} = Duckdbex.connection(db)
+    assert {:ok, _} = Duckdbex.query(conn, "CREATE TABLE pool_test(i INTEGER);")
+
+    1..100
+    |> Task.async_stream(fn i -> Duckdbex.pool_query(pool, "INSERT INTO pool_test VALUES ($1);", [i]) end)
+    |> Enum.each(fn {:ok, result} -> assert {:ok, _} = result end)
+
+    assert {:ok, res} = Duckdbex.pool_query(pool, "SELECT count(*), sum(i) FROM pool_test;")
+    assert [[100, 5050]] = Duckdbex.fetch_all(res)
+
+    assert {:error, "Parser Error: " <> _} = Duckdbex.pool_query(pool, "SELEC 1;")
+    assert_raise ArgumentError, fn -> Duckdbex.pool_query(pool, "SELECT 1;", [], stream: true) end
+
+    assert :ok = Duckdbex.release(pool)
+    assert_raise ArgumentError, fn -> Duckdbex.pool_query(pool, "SELECT 1;") end
+  end
+
+  test "pool_query/4 rolls back the transaction left open" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, pool} = Duckdbex.connection_pool(db, 1)
+    assert {:ok, _} = Duckdbex.pool_query(pool, "CREATE TABLE pool_tx(i INTEGER);")
+
+    assert {:ok, _} = Duckdbex.pool_query(pool, "BEGIN TRANSACTION; INSERT INTO pool_tx VALUES (1);")
+    assert {:ok, _} = Duckdbex.pool_query(pool, "BEGIN TRANSACTION;")
+
+    assert {:ok, res} = Duckdbex.pool_query(pool, "SELECT count(*) FROM pool_tx;")
+    assert [[0]] = Duckdbex.fetch_all(res)
+  end
+
   test "begin_transaction/1" do
     assert {:ok, db} = Duckdbex.open()
     assert {:ok, conn} = Duckdbex.connection(db)
@@ -267,6 +474,53 @@ defmodule DuckdbexTest do
              Duckdbex.query(conn, "SELECT 1 WHERE 10 <= $1;", [10.0])
   end
 
+  test "prepared statement binds the parameters on every execution" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+    assert {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT $1::INTEGER, $2::VARCHAR;")
+
+    for i <- 1..3 do
+      assert {:ok, r} = Duckdbex.execute_statement(stmt, [i, "s#{i}"])
+      assert [[^i, "s" <> _]] = Duckdbex.fetch_all(r)
+    end
+
+    assert {:ok, r} = Duckdbex.execute_statement(stmt, [nil, :atom])
+    assert [[nil, "atom"]] = Duckdbex.fetch_all(r)
+
+    assert {:error, "invalid type of parameter #2"} = Duckdbex.execute_statement(stmt, [1, 2.5])
+  end
+
+  test "execute_many/3 stops at the first failing row" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+    assert {:ok, _} = Duckdbex.query(conn, "CREATE TABLE t(i INTEGER PRIMARY KEY);")
+    assert {:ok, stmt} = Duckdbex.prepare_statement(conn, "INSERT INTO t VALUES ($1);")
+
+    assert {:error, {2, "Constraint Error" <> _}} = Duckdbex.execute_many(stmt, [[1], [2], [1], [3]])
+    assert {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM t;")
+    assert [[2]] = Duckdbex.fetch_all(r)
+
+    assert {:error, {1, "Constraint Error" <> _}} =
+             Duckdbex.execute_many(stmt, [[3], [1]], transaction: true)
+
+    assert {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM t;")
+    assert [[2]] = Duckdbex.fetch_all(r)
+
+    assert :ok = Duckdbex.begin_transaction(conn)
+    assert {:ok, 2} = Duckdbex.execute_many(stmt, [[3], [4]], transaction: true)
+    assert :ok = Duckdbex.rollback(conn)
+
+    assert {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM t;")
+    assert [[2]] = Duckdbex.fetch_all(r)
+
+    assert_raise ArgumentError, fn -> Duckdbex.execute_many(stmt, [[5]], unknown: true) end
+
+    assert_raise ArgumentError, fn -> Duckdbex.execute_many(stmt, [[5], [6 | 7]], transaction: true) end
+    assert {:ok, false} = Duckdbex.has_active_transaction(conn)
+    assert {:ok, r} = Duckdbex.query(conn, "SELECT count(*) FROM t;")
+    assert [[2]] = Duckdbex.fetch_all(r)
+  end
+
   test "multiple statement query without parameters" do
     assert {:ok, db} = Duckdbex.open()
     assert {:ok, conn} = Duckdbex.connection(db)
@@ -283,4 +537,78 @@ defmodule DuckdbexTest do
     assert {:error, "Invalid Input Error: Cannot prepare multiple statements at once!"} =
              Duckdbex.query(conn, "SELECT 1 WHERE 1 = $1; SELECT 2;", [1])
   end
+
+  test "profiling tree of the query and the prepared statement" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    assert {:ok, _} = Duckdbex.query(conn, "CREATE TABLE p AS SELECT range AS i FROM range(1000);")
+    assert nil == Duckdbex.profiling_tree(conn)
+
+    assert :ok = Duckdbex.enable_profiling(conn)
+    assert {:ok, _} = Duckdbex.query(conn, "SELECT i % 10, count(*) FROM p GROUP BY 1;")
+
+    assert %{children: [_ | _] = children, extra_info: %{}} = Duckdbex.profiling_tree(conn)
+
+    operators = flatten(children)
+    assert Enum.all?(operators, &is_binary(&1.operator_type))
+    assert %{operator_cardinality: 1000, operator_timing: timing} =
+             Enum.find(operators, &(&1.operator_type == "TABLE_SCAN"))
+
+    assert is_float(timing)
+
+    assert :ok = Duckdbex.disable_profiling(conn)
+
+    assert {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT * FROM p WHERE i < $1;")
+    assert {:ok, _} = Duckdbex.execute_statement(stmt, [5], profile: true)
+
+    assert %{children: [_ | _] = children} = Duckdbex.profiling_tree(stmt)
+    assert Enum.any?(flatten(children), &(&1.operator_type == "TABLE_SCAN"))
+
+    assert_raise ArgumentError, fn ->
+      Duckdbex.query(conn, "SELECT 1;", [], profile: true, cooperative: true)
+    end
+  end
+
+  test "the query profiled with profile: true keeps the profiler enabled by enable_profiling" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    assert {:ok, _} = Duckdbex.query(conn, "CREATE TABLE p AS SELECT range AS i FROM range(10);")
+
+    assert :ok = Duckdbex.enable_profiling(conn)
+    assert {:ok, _} = Duckdbex.query(conn, "SELECT 1;", [], profile: true)
+    assert {:ok, _} = Duckdbex.query(conn, "SELECT * FROM p;")
+
+    assert %{children: children} = Duckdbex.profiling_tree(conn)
+    assert Enum.any?(flatten(children), &(&1.operator_type == "TABLE_SCAN"))
+
+    assert :ok = Duckdbex.disable_profiling(conn)
+    assert {:ok, _} = Duckdbex.query(conn, "SELECT 1;")
+
+    assert %{children: children} = Duckdbex.profiling_tree(conn)
+    assert Enum.any?(flatten(children), &(&1.operator_type == "TABLE_SCAN"))
+  end
+
+  test "the profiling tree is taken with the result of the profiled query" do
+    assert {:ok, db} = Duckdbex.open()
+    assert {:ok, conn} = Duckdbex.connection(db)
+
+    assert {:ok, _} = Duckdbex.query(conn, "CREATE TABLE p AS SELECT range AS i FROM range(10);")
+
+    assert {:ok, res} = Duckdbex.query(conn, "SELECT * FROM p;", [], profile: true)
+    assert {:ok, stmt} = Duckdbex.prepare_statement(conn, "SELECT $1::INTEGER + 1;")
+    assert {:ok, stmt_res} = Duckdbex.execute_statement(stmt, [1], profile: true)
+    assert {:ok, plain} = Duckdbex.query(conn, "SELECT * FROM p;")
+
+    assert %{children: children} = Duckdbex.profiling_tree(res)
+    assert Enum.any?(flatten(children), &(&1.operator_type == "TABLE_SCAN"))
+
+    assert %{children: children} = Duckdbex.profiling_tree(stmt_res)
+    refute Enum.any?(flatten(children), &(&1.operator_type == "TABLE_SCAN"))
+
+    assert nil == Duckdbex.profiling_tree(plain)
+  end
+
+  defp flatten(nodes), do: Enum.flat_map(nodes, &[&1 | flatten(&1.children)])
 end
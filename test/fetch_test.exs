@@ -25,6 +25,33 @@ defmodule Duckdbex.FetchTest do
     assert [] == Duckdbex.fetch_chunk(result_ref)
   end
 
+  test "the streaming result fails the fetch with the error of the query", %{conn: conn} do
+    sql = "SELECT CASE WHEN range < 500000 THEN range ELSE error('boom') END FROM range(1000000);"
+
+    {:ok, result_ref} = Duckdbex.query(conn, sql, [], stream: true)
+
+    fetched =
+      Stream.repeatedly(fn -> Duckdbex.fetch_chunk(result_ref) end)
+      |> Enum.take_while(&match?([_ | _], &1))
+
+    assert length(fetched) > 0
+    assert {:error, "Invalid Input Error: boom"} = Duckdbex.fetch_chunk(result_ref)
+
+    {:ok, result_ref} = Duckdbex.query(conn, sql, [], stream: true)
+    assert {:error, "Invalid Input Error: boom"} = Duckdbex.fetch_all(result_ref)
+
+    {:ok, result_ref} = Duckdbex.query(conn, sql, [], stream: true)
+    assert {:error, "Invalid Input Error: boom"} = Duckdbex.fetch_all_columns(result_ref)
+  end
+
+  test "the streaming result interrupted by cancel fails the fetch", %{conn: conn} do
+    {:ok, result_ref} = Duckdbex.query(conn, "SELECT * FROM range(100000000);", [], stream: true)
+
+    assert [_ | _] = Duckdbex.fetch_chunk(result_ref)
+    assert :ok = Duckdbex.cancel(conn)
+    assert {:error, :cancelled} = Duckdbex.fetch_all(result_ref)
+  end
+
   test "divide by zero does not crash", %{conn: conn} do
     {:ok, result_ref} = Duckdbex.query(conn, "SELECT 0/0")
     assert [[:nan]] == Duckdbex.fetch_all(result_ref)
@@ -68,4 +95,118 @@ defmodule Duckdbex.FetchTest do
     assert [] == Duckdbex.fetch_all(result_ref)
     assert [] == Duckdbex.fetch_all(result_ref)
   end
+
+  test "fetch_all converts NULLs, constants and typed columns", %{conn: conn} do
+    {:ok, result_ref} =
+      Duckdbex.query(conn, """
+        SELECT
+          i::INTEGER,
+          CASE WHEN i % 2 = 0 THEN NULL ELSE i::BIGINT END,
+          'const',
+          i::DOUBLE / 2,
+          DATE '2024-01-01' + i::INTEGER,
+          i % 2 = 0
+        FROM range(3) t(i)
+      """)
+
+    assert [
+             [0, nil, "const", 0.0, {2024, 1, 1}, true],
+             [1, 1, "const", 0.5, {2024, 1, 2}, false],
+             [2, nil, "const", 1.0, {2024, 1, 3}, true]
+           ] == Duckdbex.fetch_all(result_ref)
+  end
+
+  test "fetch_all returns rows of all the chunks", %{conn: conn} do
+    {:ok, result_ref} = Duckdbex.query(conn, "SELECT i, i::VARCHAR FROM range(5000) t(i)")
+
+    rows = Duckdbex.fetch_all(result_ref)
+
+    assert 5000 == length(rows)
+    assert [4999, "4999"] == List.last(rows)
+  end
+
+  test "fetch_chunk_columns", %{conn: conn} do
+    {:ok, result_ref} =
+      Duckdbex.query(conn, "SELECT * FROM (VALUES (1, true, 'one'), (2, NULL, 'two'))")
+
+    assert [[1, 2], [true, nil], ["one", "two"]] == Duckdbex.fetch_chunk_columns(result_ref)
+    assert [] == Duckdbex.fetch_chunk_columns(result_ref)
+  end
+
+  test "fetch_all_columns", %{conn: conn} do
+    {:ok, result_ref} = Duckdbex.query(conn, "SELECT i, i::VARCHAR FROM range(5000) t(i)")
+
+    assert [numbers, strings] = Duckdbex.fetch_all_columns(result_ref)
+    assert Enum.to_list(0..4999) == numbers
+    assert Enum.map(0..4999, &Integer.to_string/1) == strings
+
+    {:ok, result_ref} = Duckdbex.query(conn, "SELECT 1 AS a, 2 AS b WHERE false")
+    assert [[], []] == Duckdbex.fetch_all_columns(result_ref)
+  end
+
+  test "fetch_chunk_packed", %{conn: conn} do
+    {:ok, result_ref} =
+      Duckdbex.query(
+        conn,
+        "SELECT * FROM (VALUES (1::BIGINT, 1.5::DOUBLE, true, 'one'), (2, NULL, false, 'two'), (3, 3.5, NULL, NULL))"
+      )
+
+    assert [
+             {:bigint, <<1::64-signed-native, 2::64-signed-native, 3::64-signed-native>>, nil},
+             {:double, <<1.5::64-float-native, _::64, 3.5::64-float-native>>, <<0b101>>},
+             {:boolean, <<1, 0, _>>, <<0b011>>},
+             ["one", "two", nil]
+           ] = Duckdbex.fetch_chunk_packed(result_ref)
+
+    assert [] == Duckdbex.fetch_chunk_packed(result_ref)
+  end
+
+  test "packed FLOAT arrays", %{conn: conn} do
+    {:ok, _} = Duckdbex.query(conn, "CREATE TABLE embeddings(id INTEGER, embedding FLOAT[3], tags INTEGER[]);")
+
+    e1 = <<1.0::float-native-32, 2.0::float-native-32, 3.0::float-native-32>>
+    e2 = <<0.5::float-native-32, 0.0::float-native-32, -1.0::float-native-32>>
+
+    {:ok, appender} = Duckdbex.appender(conn, "embeddings")
+    assert :ok = Duckdbex.appender_add_columns(appender, [[1, 2, 3], [e1, nil, e2], [<<7::native-32>>, [], nil]])
+    assert :ok = Duckdbex.appender_add_row(appender, [4, e2, <<8::native-32, 9::native-32>>])
+    assert :ok = Duckdbex.appender_close(appender)
+
+    # the binary of the wrong size
+    {:ok, appender} = Duckdbex.appender(conn, "embeddings")
+    assert {:error, _} = Duckdbex.appender_add_columns(appender, [[5], [<<1.0::float-native-32>>], [nil]])
+
+    {:ok, result_ref} = Duckdbex.query(conn, "SELECT embedding, tags FROM embeddings ORDER BY id")
+    assert [
+             {{:array, :float}, [^e1, nil, ^e2, ^e2], nil},
+             {{:list, :integer}, [<<7::native-32>>, <<>>, nil, <<8::native-32, 9::native-32>>], nil}
+           ] = Duckdbex.fetch_chunk_packed(result_ref)
+
+    {:ok, result_ref} =
+      Duckdbex.query(conn, "SELECT id FROM embeddings WHERE embedding = $1::FLOAT[3]", [e2])
+
+    assert [[3], [4]] = Duckdbex.fetch_all(result_ref)
+
+    # NULL elements are marked in the per-row element bitmaps
+    {:ok, result_ref} = Duckdbex.query(conn, "SELECT * FROM (VALUES ([1, NULL, 3]::INTEGER[]), ([4])) ORDER BY 1")
+    assert [{{:list, :integer}, [<<1::native-32, _::32, 3::native-32>>, <<4::native-32>>], [<<0b101>>, nil]}] =
+             Duckdbex.fetch_chunk_packed(result_ref)
+  end
+
+  test "fetch long and short strings", %{conn: conn} do
+    {:ok, result_ref} =
+      Duckdbex.query(
+        conn,
+        "SELECT CASE WHEN i % 3 = 0 THEN NULL WHEN i % 3 = 1 THEN repeat('x', i) ELSE i::VARCHAR END FROM range(200) t(i)"
+      )
+
+    expected =
+      Enum.map(0..199, fn
+        i when rem(i, 3) == 0 -> [nil]
+        i when rem(i, 3) == 1 -> [String.duplicate("x", i)]
+        i -> [Integer.to_string(i)]
+      end)
+
+    assert expected == Duckdbex.fetch_all(result_ref)
+  end
 end
@@ -0,0 +1,48 @@
+defmodule Duckdbex.TelemetryTest do
+  use ExUnit.Case, async: false
+
+  setup ctx do
+    {:ok, db} = Duckdbex.open(":memory:", nil)
+    {:ok, conn} = Duckdbex.connection(db)
+
+    :ok = Duckdbex.set_telemetry_collector(self())
+    on_exit(fn -> Duckdbex.set_telemetry_collector(nil) end)
+
+    Map.put(ctx, :conn, conn)
+  end
+
+  test "sends the phase timings of the calls", %{conn: conn} do
+    {:ok, r} = Duckdbex.query(conn, "SELECT * FROM range(10) WHERE range >= $1;", [5])
+
+    assert_receive {:duckdbex_telemetry, :query,
+                    %{prepare: _, bind: _, execute: execute, total: total, rows: 5}}
+
+    assert execute <= total
+
+    assert [[5] | _] = Duckdbex.fetch_all(r)
+    assert_receive {:duckdbex_telemetry, :fetch_all, %{fetch: _, convert: _, rows: 5, bytes: bytes}}
+    assert bytes > 0
+
+    {:ok, _} = Duckdbex.query(conn, "CREATE TABLE t(i INTEGER);")
+    {:ok, appender} = Duckdbex.appender(conn, "t")
+    :ok = Duckdbex.appender_add_rows(appender, [[1], [2]])
+    assert_receive {:duckdbex_telemetry, :appender_add_rows, %{append: _, rows: 2}}
+
+    :ok = Duckdbex.appender_flush(appender)
+    assert_receive {:duckdbex_telemetry, :appender_flush, %{flush: _}}
+  end
+
+  test "reports the wait of the async call", %{conn: conn} do
+    {:ok, ref} = Duckdbex.query_async(conn, "SELECT 1;", [])
+    assert {:ok, _} = Duckdbex.await(ref)
+    assert_receive {:duckdbex_telemetry, :query, %{queue: _, execute: _}}
+  end
+
+  test "nothing is sent without the collector", %{conn: conn} do
+    :ok = Duckdbex.set_telemetry_collector(nil)
+
+    {:ok, r} = Duckdbex.query(conn, "SELECT 1;")
+    [[1]] = Duckdbex.fetch_all(r)
+    refute_receive {:duckdbex_telemetry, _, _}, 100
+  end
+end
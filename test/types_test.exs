@@ -219,6 +219,11 @@ defmodule Duckdbex.TypesTest do
       assert {:ok, r} = Duckdbex.query(conn, "SELECT * FROM table1 WHERE col1 = $1;", ["sad"])
       assert [["sad"]] = Duckdbex.fetch_all(r)
     end
+
+    test "output of the column and the nested values", %{conn: conn} do
+      assert {:ok, r} = Duckdbex.query(conn, "SELECT col1, [col1] FROM table1;")
+      assert [["happy", ["happy"]], [nil, [nil]], ["sad", ["sad"]], ["ok", ["ok"]]] = Duckdbex.fetch_all(r)
+    end
   end
 
   # HUGEINT